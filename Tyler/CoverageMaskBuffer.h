@@ -122,6 +122,18 @@ namespace tyler
             }
         }
 
+        // Total # coverage masks in all slots
+        uint32_t GetNumCoverageMasks() const
+        {
+            uint32_t numCoverageMasks = 0u;
+            for (uint32_t i = 0; i < m_NumAllocations; i++)
+            {
+                numCoverageMasks += m_AllocationList[i].m_AllocationCount;
+            }
+
+            return numCoverageMasks;
+        }
+
         // Reset buffer allocations for next iteration
         void ResetAllocationList()
         {
@@ -2,15 +2,19 @@
 
 #include "RenderEngine.h"
 #include "RenderState.h"
+#include "ShaderPipeline.h"
+#include "ThreadAffinity.h"
 
 namespace tyler
 {
-    PipelineThread::PipelineThread(RenderEngine* pRenderEngine, uint32_t threadIdx)
+    PipelineThread::PipelineThread(RenderEngine* pRenderEngine, uint32_t threadIdx, uint32_t processorIdx)
         :
         m_pRenderEngine(pRenderEngine),
         m_RenderConfig(m_pRenderEngine->m_RenderConfig),
         m_ThreadIdx(threadIdx),
-        m_CurrentState(ThreadStatus::IDLE)
+        m_ProcessorIdx(processorIdx),
+        m_CurrentState(ThreadStatus::IDLE),
+        m_NumCompletedIterations(0u)
     {
         m_WorkerThread = std::thread(&PipelineThread::Run, this);
     }
@@ -18,263 +22,210 @@ namespace tyler
     PipelineThread::~PipelineThread()
     {
         m_CurrentState.store(ThreadStatus::TERMINATED);
+        m_WakeUpEvent.NotifyAll();
 
         ASSERT(m_WorkerThread.joinable());
         m_WorkerThread.join();
+
+        delete m_pTileCoverageMasks;
     }
 
     void PipelineThread::Run()
     {
-        while (m_CurrentState.load(std::memory_order_relaxed) != ThreadStatus::TERMINATED)
+        if (m_ProcessorIdx != g_scInvalidProcessorIndex)
         {
-            if (m_CurrentState.load(std::memory_order_relaxed) == ThreadStatus::DRAWCALL_TOP)
+            if (!PinCurrentThreadToLogicalProcessor(m_ProcessorIdx))
             {
-                while (!m_pRenderEngine->m_DrawcallSetupComplete.load(std::memory_order_relaxed))
-                {
-                    // Don't start processing a drawcall until all threads have draw parameters assigned
-                }
-
-                // Drawcall received, switch to processing it
-                if (m_ActiveDrawParams.m_IsIndexed)
-                {
-                    ProcessDrawcall<true>();
-                }
-                else
-                {
-                    ProcessDrawcall<false>();
-                }
+                WARN("Pipeline thread %u could not be pinned to logical processor %u\n", m_ThreadIdx, m_ProcessorIdx);
             }
-
-            std::this_thread::yield();
         }
-    }
-
-    template<bool IsIndexed>
-    void PipelineThread::ProcessDrawcall()
-    {
-        LOG("Thread %d drawcall processing begins\n", m_ThreadIdx);
-
-        ASSERT(m_pRenderEngine->m_DrawcallSetupComplete.load());
 
-        // Drawcall starts with geometry processing
-        m_CurrentState.store(ThreadStatus::DRAWCALL_GEOMETRY, std::memory_order_relaxed);
+        // Thread-private buffers are allocated (and first touched) by the worker thread itself, so that they're local to its NUMA node when pinned
+        m_pTileCoverageMasks = new CoverageMaskBuffer();
 
-        LOG("Thread %d processing geometry...\n", m_ThreadIdx);
-
-        // Iterate over triangles in assigned drawcall range
-        for (uint32_t drawIdx = m_ActiveDrawParams.m_ElemsStart, primIdx = m_ActiveDrawParams.m_ElemsStart % m_RenderConfig.m_MaxDrawIterationSize;
-            drawIdx < m_ActiveDrawParams.m_ElemsEnd;
-            drawIdx++, primIdx++)
+        while (true)
         {
-            // drawIdx = Assigned prim indices which will be only used to fetch indices
-            // primIdx = Prim index relative to current iteration
+            // Only this thread updates its # completed draw iterations
+            const uint32_t iterationIdx = m_NumCompletedIterations.load(std::memory_order_relaxed);
+
+            // Draw iterations are dispatched along with their draw parameters, next one may have been dispatched while thread was processing previous one
+            ThreadStatus currentState;
+            bool isIterationDispatched;
+            auto isWorkAvailable = [&]()
+            {
+                currentState = m_CurrentState.load(std::memory_order_acquire);
+                isIterationDispatched = (m_pRenderEngine->m_NumDispatchedIterations.load(std::memory_order_acquire) != iterationIdx);
 
-            // Clip-space vertices to be retrieved from VS
-            glm::vec4 v0Clip, v1Clip, v2Clip;
+                return (currentState == ThreadStatus::TILE_RESOLVE) || (currentState == ThreadStatus::TERMINATED) || isIterationDispatched;
+            };
 
-            // VS
-            ExecuteVertexShader<IsIndexed>(drawIdx, primIdx, &v0Clip, &v1Clip, &v2Clip);
+            // Thread only waits for work dispatched after it ran out of work
+            const bool isWakeUp = !isWorkAvailable();
 
-            // Bbox of the primitive which will be computed during clipping
-            Rect2D bbox;
+            // Spin for a while, then park until RenderEngine hands over work or thread is terminated
+            m_WakeUpEvent.Wait(isWorkAvailable);
 
-            // CLIPPER
-            if (!ExecuteFullTriangleClipping(primIdx, v0Clip, v1Clip, v2Clip, &bbox))
+            if (currentState == ThreadStatus::TERMINATED)
             {
-                // Triangle clipped, proceed iteration with next primitive
-                continue;
+                break;
             }
 
-            // TRIANGLE SETUP & CULL
-            if (!ExecuteTriangleSetupAndCull(primIdx, v0Clip, v1Clip, v2Clip))
+            if (currentState == ThreadStatus::TILE_RESOLVE)
             {
-                // Triangle culled, proceed iteration with next primitive
-                continue;
-            }
+                if constexpr (g_scWakeUpStatsEnabled)
+                {
+                    RecordWakeUpLatency(m_pRenderEngine->m_DispatchTime);
+                }
 
-            // BINNER
-            ExecuteBinner(primIdx, v0Clip, v1Clip, v2Clip, bbox);
-        }
+                ExecuteTileResolve();
+            }
+            else
+            {
+                ASSERT(isIterationDispatched && (currentState == ThreadStatus::IDLE));
 
-        ASSERT(m_CurrentState.load() <= ThreadStatus::DRAWCALL_BINNING);
+                const uint32_t slotIdx = iterationIdx % g_scMaxDrawIterationsInFlight;
+                m_pDrawIteration = &m_pRenderEngine->m_DrawIterations[slotIdx];
+                m_ActiveDrawParams = m_DrawParams[slotIdx];
 
-        LOG("Thread %d post-binning sync point\n", m_ThreadIdx);
+                if (!m_pDrawIteration->m_IsThreadTileStorageAllocated[m_ThreadIdx])
+                {
+                    AllocateTileStorage();
+                }
 
-        // To preserve rendering order, we must ensure that all threads finish binning primitives to tiles
-        // before rasterization is started. To do that, we will stall all threads to sync @DRAWCALL_RASTERIZATION
-        // Set state to post binning and stall until all PipelineThreads complete binning
-        m_CurrentState.store(ThreadStatus::DRAWCALL_SYNC_POINT_POST_BINNER, std::memory_order_release);
-        m_pRenderEngine->WaitForPipelineThreadsToCompleteBinning();
+                if constexpr (g_scWakeUpStatsEnabled)
+                {
+                    if (isWakeUp)
+                    {
+                        RecordWakeUpLatency(m_pDrawIteration->m_DispatchTime);
+                    }
+                }
 
-        LOG("Thread %d post-binning sync point reached!\n", m_ThreadIdx);
+                // Draw iteration received, switch to processing it
+                m_CurrentState.store(ThreadStatus::DRAWCALL_TOP, std::memory_order_relaxed);
 
-        // State must have been set to rasterization by RenderEngine
-        // when binnnig is "signaled" to have ended
-        ASSERT(m_CurrentState.load() < ThreadStatus::DRAWCALL_SYNC_POINT_POST_RASTER);
+                if (m_ActiveDrawParams.m_IsIndexed)
+                {
+                    ProcessDrawcall<true>();
+                }
+                else
+                {
+                    ProcessDrawcall<false>();
+                }
+            }
+        }
+    }
 
-        LOG("Thread %d rasterizing...\n", m_ThreadIdx);
+    void PipelineThread::RecordWakeUpLatency(const std::chrono::steady_clock::time_point& dispatchTime)
+    {
+        const uint64_t latency = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - dispatchTime).count());
 
-        // RASTERIZATION
-        ExecuteRasterizer();
+        m_NumWakeUps++;
+        m_TotalWakeUpLatency += latency;
+        m_MaxWakeUpLatency = glm::max(m_MaxWakeUpLatency, latency);
+    }
 
-        LOG("Thread %d post-raster sync point\n", m_ThreadIdx);
+    void PipelineThread::AllocateTileStorage()
+    {
+        // Like m_pTileCoverageMasks, these are allocated (and first touched) by the thread filling them, so that they're local to its NUMA node when pinned
+        // Other threads only read them once the thread is done binning, i.e. after they're allocated
+        const uint32_t numTiles = static_cast<uint32_t>(m_pDrawIteration->m_BinList.size());
+        for (uint32_t tileIdx = 0; tileIdx < numTiles; tileIdx++)
+        {
+            // Only reserve the memory for per-thread primitive indices!
+            m_pDrawIteration->m_BinList[tileIdx][m_ThreadIdx].reserve(m_RenderConfig.m_MaxDrawIterationSize / m_RenderConfig.m_NumPipelineThreads);
 
-        // Rasterization completed, set state to post raster and
-        // stall until all PipelineThreads complete rasterization.
-        // We need this sync because when (N-x) threads finish rasterization and
-        // reach the end of tile queue while x threads are still busy rasterizing tile blocks,
-        // we must ensure that none of the (N-x) non-busy threads will go ahead and start fragment-shading tiles
-        // whose blocks could be currently still rasterized by x remaining threads
-        m_CurrentState.store(ThreadStatus::DRAWCALL_SYNC_POINT_POST_RASTER, std::memory_order_release);
-        m_pRenderEngine->WaitForPipelineThreadsToCompleteRasterization();
+            if constexpr (!g_scFusedRasterShadeEnabled)
+            {
+                ASSERT(m_pDrawIteration->m_CoverageMasks[tileIdx][m_ThreadIdx] == nullptr);
+                m_pDrawIteration->m_CoverageMasks[tileIdx][m_ThreadIdx] = new CoverageMaskBuffer();
+            }
+        }
 
-        LOG("Thread %d post-raster sync point reached!\n", m_ThreadIdx);
+        m_pDrawIteration->m_IsThreadTileStorageAllocated[m_ThreadIdx] = 1u;
+    }
 
-        // State must have been set to fragment shader by RenderEngine
-        // when rasterization is "signaled" to have ended
-        ASSERT(m_CurrentState.load() == ThreadStatus::DRAWCALL_FRAGMENTSHADER);
+    void PipelineThread::ExecuteTileResolve()
+    {
+        LOG("Thread %d resolving tiles...\n", m_ThreadIdx);
 
-        LOG("Thread %d fragment-shading...\n", m_ThreadIdx);
+        const uint32_t numTiles = static_cast<uint32_t>(m_pRenderEngine->m_TileList.size());
 
-        // FS
-        ExecuteFragmentShader();
+        uint32_t tileIdx;
+        while ((tileIdx = m_pRenderEngine->m_NextTileToResolve.fetch_add(1u, std::memory_order_relaxed)) < numTiles)
+        {
+            m_pRenderEngine->ResolveTile(tileIdx, m_pRenderEngine->m_FastClearsToResolve);
+        }
 
-        LOG("Thread %d drawcall ended\n", m_ThreadIdx);
+        // Make streaming stores visible before framebuffer is handed over
+        _mm_sfence();
 
-        // Draw iteration completed
-        m_CurrentState.store(ThreadStatus::DRAWCALL_BOTTOM, std::memory_order_relaxed);
+        m_CurrentState.store(ThreadStatus::IDLE, std::memory_order_release);
+        m_pRenderEngine->m_ThreadCompletionEvent.NotifyAll();
     }
 
     template<bool IsIndexed>
-    void PipelineThread::ExecuteVertexShader(uint32_t drawIdx, uint32_t primIdx, glm::vec4* pV0Clip, glm::vec4* pV1Clip, glm::vec4* pV2Clip)
+    void PipelineThread::ProcessDrawcall()
     {
-        uint8_t* pVertexBuffer = static_cast<uint8_t*>(m_pRenderEngine->m_pVertexBuffer);
-        IndexBuffer* pIndexBuffer = m_pRenderEngine->m_pIndexBuffer;
-        ASSERT((pVertexBuffer != nullptr) && (!IsIndexed || (pIndexBuffer != nullptr)));
-
-        ConstantBuffer* pConstantBuffer = m_pRenderEngine->m_pConstantBuffer;
-
-        uint32_t vertexStride = m_pRenderEngine->m_VertexInputStride;
-        uint32_t vertexOffset = m_ActiveDrawParams.m_VertexOffset;
-
-        VertexAttributes* pTempVertexAttrib0 = &m_TempVertexAttributes[0];
-        VertexAttributes* pTempVertexAttrib1 = &m_TempVertexAttributes[1];
-        VertexAttributes* pTempVertexAttrib2 = &m_TempVertexAttributes[2];
-
-        VertexShader VS = m_pRenderEngine->m_VertexShader;
-        ASSERT(VS != nullptr);
+        LOG("Thread %d drawcall processing begins\n", m_ThreadIdx);
 
-        if constexpr (g_scVertexShaderCacheEnabled && IsIndexed)
-        {
-            uint32_t cacheEntry0 = UINT32_MAX;
-            uint32_t cacheEntry1 = UINT32_MAX;
-            uint32_t cacheEntry2 = UINT32_MAX;
+        ASSERT(m_pDrawIteration != nullptr);
 
-            uint32_t vertexIdx0 = pIndexBuffer[vertexOffset + (3 * drawIdx + 0)];
-            uint32_t vertexIdx1 = pIndexBuffer[vertexOffset + (3 * drawIdx + 1)];
-            uint32_t vertexIdx2 = pIndexBuffer[vertexOffset + (3 * drawIdx + 2)];
+        // Drawcall starts with geometry processing
+        m_CurrentState.store(ThreadStatus::DRAWCALL_GEOMETRY, std::memory_order_relaxed);
 
-            if (PerformVertexCacheLookup(vertexIdx0, &cacheEntry0))
-            {
-                // Vertex 0 is found in the cache, skip VS and fetch cached data
-                CopyVertexData(cacheEntry0, pV0Clip, pTempVertexAttrib0);
-            }
-            else
-            {
-                // Vertex 0 is not found in the cache,
-                // first invoke VS and then cache the clip-space position & vertex attributes
+        LOG("Thread %d processing geometry...\n", m_ThreadIdx);
 
-                uint8_t* pVertIn0 = &pVertexBuffer[vertexStride * vertexIdx0];
-                *pV0Clip = VS(pVertIn0, pTempVertexAttrib0, pConstantBuffer);
+        // VS, clipper, triangle setup and binner of the bound shader pipeline
+        m_pRenderEngine->m_pShaderPipeline->ExecuteGeometry(this, IsIndexed, m_pRenderEngine->m_IsDepthOnly);
 
-                CacheVertexData(vertexIdx0, *pV0Clip, *pTempVertexAttrib0);
-            }
+        ASSERT(m_CurrentState.load() <= ThreadStatus::DRAWCALL_BINNING);
 
-            if (PerformVertexCacheLookup(vertexIdx1, &cacheEntry1))
-            {
-                // Vertex 1 is found in the cache, skip VS and fetch cached data
-                CopyVertexData(cacheEntry1, pV1Clip, pTempVertexAttrib1);
-            }
-            else
-            {
-                // Vertex 1 is not found in the cache,
-                // first invoke VS and then cache the clip-space position & vertex attributes
+        LOG("Thread %d post-binning sync point\n", m_ThreadIdx);
 
-                uint8_t* pVertIn1 = &pVertexBuffer[vertexStride * vertexIdx1];
-                *pV1Clip = VS(pVertIn1, pTempVertexAttrib1, pConstantBuffer);
+        // To preserve rendering order, we must ensure that all threads finish binning primitives to tiles
+        // before rasterization is started. To do that, we will stall all threads to sync @DRAWCALL_RASTERIZATION
+        // Set state to post binning and stall until all PipelineThreads complete binning of the draw iteration
+        m_CurrentState.store(ThreadStatus::DRAWCALL_SYNC_POINT_POST_BINNER, std::memory_order_relaxed);
+        if (m_pDrawIteration->m_NumThreadsBinned.fetch_add(1u, std::memory_order_acq_rel) == (m_RenderConfig.m_NumPipelineThreads - 1))
+        {
+            // Last thread to complete binning prepares queued tiles for rasterization and releases the rest
+            m_pRenderEngine->SignalBinningComplete(m_pDrawIteration);
+        }
+        m_pRenderEngine->WaitForPipelineThreadsToCompleteBinning(m_pDrawIteration);
 
-                CacheVertexData(vertexIdx1, *pV1Clip, *pTempVertexAttrib1);
-            }
+        LOG("Thread %d post-binning sync point reached!\n", m_ThreadIdx);
 
-            if (PerformVertexCacheLookup(vertexIdx2, &cacheEntry2))
-            {
-                // Vertex 2 is found in the cache, skip VS and fetch cached data
-                CopyVertexData(cacheEntry2, pV2Clip, pTempVertexAttrib2);
-            }
-            else
-            {
-                // Vertex 2 is not found in the cache,
-                // first invoke VS and then cache the clip-space position & vertex attributes
+        m_CurrentState.store(ThreadStatus::DRAWCALL_RASTERIZATION, std::memory_order_relaxed);
 
-                uint8_t* pVertIn2 = &pVertexBuffer[vertexStride * vertexIdx2];
-                *pV2Clip = VS(pVertIn2, pTempVertexAttrib2, pConstantBuffer);
+        // Primitives of order-independent drawcalls are rasterized as they're fragment-shaded
+        if (!g_scFusedRasterShadeEnabled && !m_pRenderEngine->m_IsOrderIndependent)
+        {
+            LOG("Thread %d rasterizing...\n", m_ThreadIdx);
 
-                CacheVertexData(vertexIdx0, *pV2Clip, *pTempVertexAttrib2);
-            }
+            // RASTERIZATION
+            ExecuteRasterizer();
         }
-        else if (IsIndexed)
-        {
-            // VS$ disabled, don't look up vertices in the cache
 
-            // Fetch pointers to vertex input that'll be passed to vertex shader
-            uint8_t* pVertIn0 = &pVertexBuffer[vertexStride * pIndexBuffer[vertexOffset + (3 * drawIdx + 0)]];
-            uint8_t* pVertIn1 = &pVertexBuffer[vertexStride * pIndexBuffer[vertexOffset + (3 * drawIdx + 1)]];
-            uint8_t* pVertIn2 = &pVertexBuffer[vertexStride * pIndexBuffer[vertexOffset + (3 * drawIdx + 2)]];
+        // Rasterization completed, go ahead with fragment-shading without waiting for other threads to complete rasterization.
+        // Each tile is rasterized by a single thread, so a tile whose blocks could still be rasterized by another thread
+        // is only waited on when it's fetched for fragment shading, see RenderEngine::WaitForTileToCompleteRasterization()
+        // Tiles are rasterized as they're fragment-shaded if fused raster & shade is enabled
+        // Likewise, a tile still being fragment-shaded in previous draw iteration is only waited on when it's fetched
+        m_CurrentState.store(ThreadStatus::DRAWCALL_FRAGMENTSHADER, std::memory_order_relaxed);
 
-            // Invoke vertex shader with vertex attributes payload
-            *pV0Clip = VS(pVertIn0, pTempVertexAttrib0, pConstantBuffer);
-            *pV1Clip = VS(pVertIn1, pTempVertexAttrib1, pConstantBuffer);
-            *pV2Clip = VS(pVertIn2, pTempVertexAttrib2, pConstantBuffer);
-        }
-        else
-        {
-            // Fetch pointers to vertex input that'll be passed to vertex shader
-            uint8_t* pVertIn0 = &pVertexBuffer[vertexOffset + vertexStride * (3 * drawIdx + 0)];
-            uint8_t* pVertIn1 = &pVertexBuffer[vertexOffset + vertexStride * (3 * drawIdx + 1)];
-            uint8_t* pVertIn2 = &pVertexBuffer[vertexOffset + vertexStride * (3 * drawIdx + 2)];
-
-            // Invoke vertex shader with vertex attributes payload
-            *pV0Clip = VS(pVertIn0, pTempVertexAttrib0, pConstantBuffer);
-            *pV1Clip = VS(pVertIn1, pTempVertexAttrib1, pConstantBuffer);
-            *pV2Clip = VS(pVertIn2, pTempVertexAttrib2, pConstantBuffer);
-        }
+        LOG("Thread %d fragment-shading...\n", m_ThreadIdx);
 
-        // Calculate interpolation data for active vertex attributes
-        CalculateInterpolationCoefficients(primIdx, *pTempVertexAttrib0, *pTempVertexAttrib1, *pTempVertexAttrib2);
-    }
+        // FS
+        m_pRenderEngine->m_pShaderPipeline->ExecuteFragmentShader(this, m_pRenderEngine->m_FragmentStageVariant);
 
-    void PipelineThread::CopyVertexData(uint32_t cacheEntry, glm::vec4* pVClip, VertexAttributes* pTempVertexAttrib)
-    {
-        ASSERT((pVClip != nullptr) && (pTempVertexAttrib != nullptr));
-
-        // Copy cached clip-space positions
-        *pVClip = m_VertexCacheEntries[cacheEntry].m_ClipPos;
-
-        // Copy vertex (only active!) attributes
-        memcpy(
-            pTempVertexAttrib->m_Attributes2,
-            m_VertexCacheEntries[cacheEntry].m_VertexAttribs.m_Attributes2,
-            sizeof(glm::vec2) * m_pRenderEngine->m_ShaderMetadata.m_NumVec2Attributes);
-
-        memcpy(
-            pTempVertexAttrib->m_Attributes3,
-            m_VertexCacheEntries[cacheEntry].m_VertexAttribs.m_Attributes3,
-            sizeof(glm::vec3) * m_pRenderEngine->m_ShaderMetadata.m_NumVec3Attributes);
-
-        memcpy(
-            pTempVertexAttrib->m_Attributes4,
-            m_VertexCacheEntries[cacheEntry].m_VertexAttribs.m_Attributes4,
-            sizeof(glm::vec4) * m_pRenderEngine->m_ShaderMetadata.m_NumVec4Attributes);
+        LOG("Thread %d drawcall ended\n", m_ThreadIdx);
+
+        // Draw iteration completed, thread can start processing next one right away if dispatched already
+        // Data of the draw iteration can't be reused by RenderEngine until all threads are done with it
+        m_CurrentState.store(ThreadStatus::IDLE, std::memory_order_relaxed);
+        m_NumCompletedIterations.fetch_add(1u, std::memory_order_release);
+        m_pRenderEngine->m_ThreadCompletionEvent.NotifyAll();
     }
 
     void PipelineThread::CacheVertexData(uint32_t vertexIdx, const glm::vec4& vClip, const tyler::VertexAttributes& tempVertexAttrib)
@@ -431,7 +382,7 @@ namespace tyler
                 *pBbox = bbox;
 
                 // Cache bbox of the primitive
-                m_pRenderEngine->m_SetupBuffers.m_pPrimBBoxes[primIdx] = bbox;
+                m_pDrawIteration->m_SetupBuffers.m_pPrimBBoxes[primIdx] = bbox;
 
                 return true;
             }
@@ -457,7 +408,7 @@ namespace tyler
                 *pBbox = bbox;
 
                 // Cache bbox of the primitive
-                m_pRenderEngine->m_SetupBuffers.m_pPrimBBoxes[primIdx] = bbox;
+                m_pDrawIteration->m_SetupBuffers.m_pPrimBBoxes[primIdx] = bbox;
 
                 return true;
             }
@@ -492,7 +443,7 @@ namespace tyler
                 *pBbox = bbox;
 
                 // Cache bbox of the primitive
-                m_pRenderEngine->m_SetupBuffers.m_pPrimBBoxes[primIdx] = bbox;
+                m_pDrawIteration->m_SetupBuffers.m_pPrimBBoxes[primIdx] = bbox;
 
                 // No clipping 
                 return true;
@@ -502,8 +453,6 @@ namespace tyler
 
     bool PipelineThread::ExecuteTriangleSetupAndCull(uint32_t primIdx, const glm::vec4& v0Clip, const glm::vec4& v1Clip, const glm::vec4& v2Clip)
     {
-        //TODO: Cull degenerate and back-facing primitives if culling is enabled
-
         // Transform a given vertex in clip-space [-w,w] to device-space homogeneous coordinates [0, {w|h}]
 #define TO_HOMOGEN(clipPos, width, height) glm::vec4((width * (clipPos.x + clipPos.w) * 0.5f), (height * (clipPos.y + clipPos.w) * 0.5f), clipPos.z, clipPos.w)
 
@@ -540,21 +489,44 @@ namespace tyler
 
         // Additionally,
         // det(M) == 0 -> degenerate/zero-area triangle
-        // det(M) < 0  -> back-facing triangle
+        // det(M) > 0  -> counter-clockwise triangle (as seen in framebuffer with row 0 at the top)
+        // det(M) < 0  -> clockwise triangle
         float detM = (c0 * v0Homogen.w) + (c1 * v1Homogen.w) + (c2 * v2Homogen.w);
 
+        // Cull degenerate triangles (NaN included) and those facing away as per bound pipeline state
+        const PipelineState* pPipelineState = m_pRenderEngine->m_pPipelineState;
+        if (!(std::abs(detM) > 0.f) || ((detM > 0.f) ? pPipelineState->m_CullCounterClockwise : pPipelineState->m_CullClockwise))
+        {
+            return false;
+        }
+
+        if (detM < 0.f)
+        {
+            // Flip signs of EEs of clockwise triangles, so that their inside is also where all edge functions are positive
+            a0 = -a0; a1 = -a1; a2 = -a2;
+            b0 = -b0; b1 = -b1; b2 = -b2;
+            c0 = -c0; c1 = -c1; c2 = -c2;
+            detM = -detM;
+        }
+
         // Assign computed EE coefficients for given primitive
-        m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0] = { a0, b0, c0 };
-        m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1] = { a1, b1, c1 };
-        m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2] = { a2, b2, c2 };
+        m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0] = { a0, b0, c0 };
+        m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1] = { a1, b1, c1 };
+        m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2] = { a2, b2, c2 };
 
-        // Store clip-space Z interpolation deltas in the setup buffer that will be used for perspective-correct interpolation of Z
-        m_pRenderEngine->m_SetupBuffers.m_pInterpolatedZValues[primIdx] = { (v0Clip.z - v2Clip.z), (v1Clip.z - v2Clip.z), v2Clip.z };
+        // Z/W is affine in screen space: Z/W(x, y) = (z0 * F0(x, y) + z1 * F1(x, y) + z2 * F2(x, y)) / det(M)
+        // so we store its plane equation coefficients which won't require perspective-correct interpolation of Z
+        const float invDetM = 1.f / detM;
 
-        //TODO: Proper culling? Render back-facing tris by flipping sign of EEs?!
+        m_pDrawIteration->m_SetupBuffers.m_pDepthPlaneCoefficients[primIdx] =
+        {
+            ((v0Clip.z * a0) + (v1Clip.z * a1) + (v2Clip.z * a2)) * invDetM,
+            ((v0Clip.z * b0) + (v1Clip.z * b1) + (v2Clip.z * b2)) * invDetM,
+            ((v0Clip.z * c0) + (v1Clip.z * c1) + (v2Clip.z * c2)) * invDetM
+        };
 
-        // Return whether the primitive should be culled
-        return detM > 0.f;
+        // Primitive survived culling
+        return true;
     }
 
     void PipelineThread::ExecuteBinner(uint32_t primIdx, const Rect2D& bbox)
@@ -586,9 +558,9 @@ namespace tyler
         ASSERT((minTileY <= maxTileY) && (maxTileY <= m_pRenderEngine->m_NumTilePerColumn));
 
         // Fetch edge equation coefficients computed in triangle setup
-        glm::vec3 ee0 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0];
-        glm::vec3 ee1 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1];
-        glm::vec3 ee2 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2];
+        glm::vec3 ee0 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0];
+        glm::vec3 ee1 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1];
+        glm::vec3 ee2 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2];
 
         // Normalize edge functions
         ee0 /= (glm::abs(ee0.x) + glm::abs(ee0.y));
@@ -689,8 +661,21 @@ namespace tyler
 
                         LOG("Tile %d TA'd by thread %d\n", m_pRenderEngine->GetGlobalTileIndex(tx, ty), m_ThreadIdx);
 
+                        if constexpr (!g_scBinnerEmitsTrivialAcceptMasks)
+                        {
+                            // Bin the triangle for the tile, to be fragment-shaded in order with other primitives binned for the tile
+                            // Per-thread TA coverage masks would only be in order if threads processed contiguous ranges of primitives in thread order
+                            m_pRenderEngine->BinPrimitiveForTile(
+                                m_pDrawIteration,
+                                m_ThreadIdx,
+                                m_pRenderEngine->GetGlobalTileIndex(tx, ty),
+                                primIdx | g_scBinnedPrimTrivialAcceptFlag);
+
+                            continue;
+                        }
+
                         // Append tile to the rasterizer queue
-                        m_pRenderEngine->EnqueueTileForRasterization(m_pRenderEngine->GetGlobalTileIndex(tx, ty));
+                        m_pRenderEngine->EnqueueTileForRasterization(m_pDrawIteration, m_pRenderEngine->GetGlobalTileIndex(tx, ty));
 
                         CoverageMask mask;
                         mask.m_SampleX = static_cast<uint32_t>(tilePosX + txxOffset); // Based off of first tile position calculated above
@@ -700,6 +685,7 @@ namespace tyler
 
                         // Emit full-tile coverage mask
                         m_pRenderEngine->AppendCoverageMask(
+                            m_pDrawIteration,
                             m_ThreadIdx,
                             m_pRenderEngine->GetGlobalTileIndex(tx, ty),
                             mask);
@@ -711,6 +697,7 @@ namespace tyler
                         // Overlap
                         // Tile is partially covered by the triangle, bin the triangle for the tile
                         m_pRenderEngine->BinPrimitiveForTile(
+                            m_pDrawIteration,
                             m_ThreadIdx,
                             m_pRenderEngine->GetGlobalTileIndex(tx, ty),
                             primIdx);
@@ -723,573 +710,492 @@ namespace tyler
     void PipelineThread::ExecuteRasterizer()
     {
         // Request next (global) index of the tile to be rasterized at block level from RenderEngine
-        uint32_t nextTileIdx;
-        while ((nextTileIdx = m_pRenderEngine->FetchNextTileForRasterization()) != g_scInvalidTileIndex)
+        uint32_t nextQueueEntry;
+        while ((nextQueueEntry = m_pRenderEngine->FetchNextTileForRasterization(m_pDrawIteration)) != g_scInvalidTileIndex)
         {
+            if (RenderEngine::GetQueuedWorkItemIndex(nextQueueEntry) != 0u)
+            {
+                // A split tile is still rasterized as a whole, by the thread that fetched its first sub-tile
+                continue;
+            }
+
+            const uint32_t nextTileIdx = RenderEngine::GetQueuedTileIndex(nextQueueEntry);
+
             LOG("Thread %d rasterizing tile %d\n", m_ThreadIdx, nextTileIdx);
 
             ASSERT(nextTileIdx < (m_pRenderEngine->m_NumTilePerRow * m_pRenderEngine->m_NumTilePerColumn));
 
             // Grabbed next tile from the queue, scan through its per-thread bins to rasterize the primitives
-            ASSERT(m_pRenderEngine->m_BinList[nextTileIdx].size() == m_RenderConfig.m_NumPipelineThreads);
+            ASSERT(m_pDrawIteration->m_BinList[nextTileIdx].size() == m_RenderConfig.m_NumPipelineThreads);
 
             // Tile must have been appended to the rasterizer queue, otherwise binning was incorrectly done for primitive!
-            ASSERT(m_pRenderEngine->m_TileList[nextTileIdx].m_IsTileQueued.test_and_set());
-
-            // Tile origin
-            const float tilePosX = m_pRenderEngine->m_TileList[nextTileIdx].m_PosX;
-            const float tilePosY = m_pRenderEngine->m_TileList[nextTileIdx].m_PosY;
-
-            // Go through all per-thread bins in-order
-            for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
-            {
-                // If a tile was trivially accepted, its bin will be empty
-                const std::vector<uint32_t>& perThreadBin = m_pRenderEngine->m_BinList[nextTileIdx][i];
+            ASSERT(m_pDrawIteration->m_TileStates[nextTileIdx].m_IsTileQueued.test_and_set());
 
-                LOG("Tile %d thread %d bin size: %d\n", nextTileIdx, i, perThreadBin.size());
+            // Coverage masks of the tile are emitted to this thread's buffer of the tile
+            CoverageMaskBuffer* pCoverageMaskBuffer = m_pDrawIteration->m_CoverageMasks[nextTileIdx][m_ThreadIdx];
 
-                // Go through all primitives in current per-thread bin in-order
-                for (uint32_t p = 0; p < perThreadBin.size(); p++)
-                {
-                    // Get next (global) primitive index to be rasterized
-                    uint32_t primIdx = perThreadBin[p];
+            SetActiveSubTile(nextTileIdx, 0u, 1u);
 
-                    // Copy prim's bbox to clamp it to the tile edges
-                    Rect2D bbox = m_pRenderEngine->m_SetupBuffers.m_pPrimBBoxes[primIdx];
-                    bbox.m_MinX = glm::max(bbox.m_MinX, tilePosX);
-                    bbox.m_MinY = glm::max(bbox.m_MinY, tilePosY);
-                    bbox.m_MaxX = glm::min(bbox.m_MaxX, tilePosX + m_RenderConfig.m_TileSize);
-                    bbox.m_MaxY = glm::min(bbox.m_MaxY, tilePosY + m_RenderConfig.m_TileSize);
+            // Go through all primitives binned for the tile in-order
+            GatherBinnedPrimitives(nextTileIdx);
 
-                    // In case bbox is screwed up after clamping to the tile edges
-                    ASSERT((bbox.m_MinX <= bbox.m_MaxX) && (bbox.m_MinY <= bbox.m_MaxY));
+            LOG("Tile %d bin size: %d\n", nextTileIdx, m_BinnedPrimitives.size());
 
-                    // Given a fixed 8x8 block and tile size, find min/max range of the blocks that fall within bbox computed above
-                    // which we're going to iterate over, in order to determine how blocks within tile are to be rasterized
+            for (uint32_t binnedPrimIdx : m_BinnedPrimitives)
+            {
+                // Rasterize next (global) primitive index in bin
+                RasterizePrimitive(nextTileIdx, binnedPrimIdx, pCoverageMaskBuffer);
+            }
 
-                    // Use floor(), min indices are inclusive
-                    uint32_t minBlockX = static_cast<uint32_t>(glm::floor((bbox.m_MinX - tilePosX) / g_scPixelBlockSize));
-                    uint32_t minBlockY = static_cast<uint32_t>(glm::floor((bbox.m_MinY - tilePosY) / g_scPixelBlockSize));
+            // All coverage masks of the tile are emitted, so it can be fragment-shaded while other tiles are still rasterized
+            m_pRenderEngine->SignalTileRasterizationComplete(m_pDrawIteration, nextTileIdx);
+        }
+    }
 
-                    // Use ceil(), max indices are exclusive
-                    uint32_t maxBlockX = static_cast<uint32_t>(glm::ceil((bbox.m_MaxX - tilePosX) / g_scPixelBlockSize));
-                    uint32_t maxBlockY = static_cast<uint32_t>(glm::ceil((bbox.m_MaxY - tilePosY) / g_scPixelBlockSize));
+    void PipelineThread::SetActiveSubTile(uint32_t tileIdx, uint32_t subTileIdx, uint32_t numSubTiles)
+    {
+        ASSERT((subTileIdx < numSubTiles) && (numSubTiles <= (m_RenderConfig.m_TileSize / g_scPixelBlockSize)));
 
-                    ASSERT((minBlockX <= maxBlockX) && (maxBlockX <= m_RenderConfig.m_TileSize / g_scPixelBlockSize));
-                    ASSERT((minBlockY <= maxBlockY) && (maxBlockY <= m_RenderConfig.m_TileSize / g_scPixelBlockSize));
+        // Sub-tiles are ranges of whole block rows
+        const uint32_t numBlockRows = m_RenderConfig.m_TileSize / g_scPixelBlockSize;
+        const uint32_t tilePosY = static_cast<uint32_t>(m_pRenderEngine->m_TileList[tileIdx].m_PosY);
 
-                    // Use EE coefficients calculated in TriangleSetup again to rasterize primitive at the 8x8 block level
-                    glm::vec3 ee0 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0];
-                    glm::vec3 ee1 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1];
-                    glm::vec3 ee2 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2];
+        m_SubTileMinY = tilePosY + ((subTileIdx * numBlockRows) / numSubTiles) * g_scPixelBlockSize;
+        m_SubTileMaxY = tilePosY + (((subTileIdx + 1) * numBlockRows) / numSubTiles) * g_scPixelBlockSize;
+    }
 
-                    // Normalize edge functions
-                    ee0 /= (glm::abs(ee0.x) + glm::abs(ee0.y));
-                    ee1 /= (glm::abs(ee1.x) + glm::abs(ee1.y));
-                    ee2 /= (glm::abs(ee2.x) + glm::abs(ee2.y));
+    void PipelineThread::GatherBinnedPrimitives(uint32_t tileIdx)
+    {
+        const std::vector<std::vector<uint32_t>>& perThreadBins = m_pDrawIteration->m_BinList[tileIdx];
+        ASSERT(perThreadBins.size() == m_RenderConfig.m_NumPipelineThreads);
 
-                    static constexpr glm::vec2 scBlockCornerOffsets[] =
-                    {
-                        { 0.f, 0.f},                                // LL (origin)
-                        { g_scPixelBlockSize, 0.f },                // LR
-                        { 0.f, g_scPixelBlockSize },                // UL
-                        { g_scPixelBlockSize, g_scPixelBlockSize}   // UR
-                    };
-
-                    // (x, y) -> sample location | (a, b, c) -> edge equation coefficients
-                    // E(x, y) = (a * x) + (b * y) + c
-                    // E(x + s, y + t) = E(x, y) + (a * s) + (b * t)
-
-                    // Based on edge normal n=(a, b), set up block TR corners for each edge once
-                    const uint8_t edge0TRCorner = (ee0.y >= 0.f) ? ((ee0.x >= 0.f) ? 3u : 2u) : (ee0.x >= 0.f) ? 1u : 0u;
-                    const uint8_t edge1TRCorner = (ee1.y >= 0.f) ? ((ee1.x >= 0.f) ? 3u : 2u) : (ee1.x >= 0.f) ? 1u : 0u;
-                    const uint8_t edge2TRCorner = (ee2.y >= 0.f) ? ((ee2.x >= 0.f) ? 3u : 2u) : (ee2.x >= 0.f) ? 1u : 0u;
-
-                    const uint8_t edge0TACorner = 3u - edge0TRCorner;
-                    const uint8_t edge1TACorner = 3u - edge1TRCorner;
-                    const uint8_t edge2TACorner = 3u - edge2TRCorner;
-
-                    // Evaluate edge function for the first block within [minBlock, maxBlock] region
-                    // once and re-use it by stepping from it within following nested loop
-
-                    const float firstBlockWithinBBoxX = tilePosX + minBlockX * g_scPixelBlockSize;
-                    const float firstBlockWithinBBoxY = tilePosY + minBlockY * g_scPixelBlockSize;
-
-                    // Evaluate edge equation at first block origin
-                    const float edgeFunc0 = ee0.z + ((ee0.x * firstBlockWithinBBoxX) + (ee0.y * firstBlockWithinBBoxY));
-                    const float edgeFunc1 = ee1.z + ((ee1.x * firstBlockWithinBBoxX) + (ee1.y * firstBlockWithinBBoxY));
-                    const float edgeFunc2 = ee2.z + ((ee2.x * firstBlockWithinBBoxX) + (ee2.y * firstBlockWithinBBoxY));
-
-                    // Iterate over calculated range of blocks within the tile
-                    for (uint32_t by = minBlockY, byy = 0; by < maxBlockY; by++, byy++)
-                    {
-                        for (uint32_t bx = minBlockX, bxx = 0; bx < maxBlockX; bx++, bxx++)
-                        {
-                            // Using EE coefficients calculated in TriangleSetup stage and positive half-space tests, determine one of three cases possible for each block:
-                            // 1) TrivialReject -- block within tri's bbox does not intersect tri -> move on
-                            // 2) TrivialAccept -- block within tri's bbox is completely within tri -> emit a full-block coverage mask
-                            // 3) Overlap       -- block within tri's bbox intersects tri -> descend into block level to emit coverage masks at pixel granularity
-
-                            // (bxx, byy) = How many steps are done per dimension
-                            const float bxxOffset = static_cast<float>(bxx * g_scPixelBlockSize);
-                            const float byyOffset = static_cast<float>(byy * g_scPixelBlockSize);
-
-                            // Step down from edge function computed above for the first block in bbox
-                            float edgeFuncTR0 = edgeFunc0 + ((ee0.x * (scBlockCornerOffsets[edge0TRCorner].x + bxxOffset)) + (ee0.y * (scBlockCornerOffsets[edge0TRCorner].y + byyOffset)));
-                            float edgeFuncTR1 = edgeFunc1 + ((ee1.x * (scBlockCornerOffsets[edge1TRCorner].x + bxxOffset)) + (ee1.y * (scBlockCornerOffsets[edge1TRCorner].y + byyOffset)));
-                            float edgeFuncTR2 = edgeFunc2 + ((ee2.x * (scBlockCornerOffsets[edge2TRCorner].x + bxxOffset)) + (ee2.y * (scBlockCornerOffsets[edge2TRCorner].y + byyOffset)));
-
-                            // If TR corner of the block is outside an edge, reject whole block
-                            bool TRForEdge0 = (edgeFuncTR0 < 0.f);
-                            bool TRForEdge1 = (edgeFuncTR1 < 0.f);
-                            bool TRForEdge2 = (edgeFuncTR2 < 0.f);
-                            if (TRForEdge0 || TRForEdge1 || TRForEdge2)
-                            {
-                                LOG("Tile %d block (%d, %d) TR'd by thread %d\n", nextTileIdx, bx, by, m_ThreadIdx);
+        m_BinnedPrimitives.clear();
 
-                                // TrivialReject
-                                // Block is completely outside of one or more edges
-                                continue;
-                            }
-                            else
-                            {
-                                // Block is partially or completely inside one or more edges, do TrivialAccept tests first
-
-                                // Compute edge functions at TA corners by stepping from first block position calculated above
-                                float edgeFuncTA0 = edgeFunc0 + ((ee0.x * (scBlockCornerOffsets[edge0TACorner].x + bxxOffset)) + (ee0.y * (scBlockCornerOffsets[edge0TACorner].y + byyOffset)));
-                                float edgeFuncTA1 = edgeFunc1 + ((ee1.x * (scBlockCornerOffsets[edge1TACorner].x + bxxOffset)) + (ee1.y * (scBlockCornerOffsets[edge1TACorner].y + byyOffset)));
-                                float edgeFuncTA2 = edgeFunc2 + ((ee2.x * (scBlockCornerOffsets[edge2TACorner].x + bxxOffset)) + (ee2.y * (scBlockCornerOffsets[edge2TACorner].y + byyOffset)));
-
-                                // If TA corner of the block is inside all edges, accept whole block
-                                bool TAForEdge0 = (edgeFuncTA0 >= 0.f);
-                                bool TAForEdge1 = (edgeFuncTA1 >= 0.f);
-                                bool TAForEdge2 = (edgeFuncTA2 >= 0.f);
-                                if (TAForEdge0 && TAForEdge1 && TAForEdge2)
-                                {
-                                    // TrivialAccept
-                                    // Block is completely inside of the triangle, emit a full-block coverage mask
+        if constexpr (!g_scDynamicGeometryDistributionEnabled)
+        {
+            // Threads process contiguous ranges of primitives in thread order, so per-thread bins follow each other
+            for (const std::vector<uint32_t>& perThreadBin : perThreadBins)
+            {
+                m_BinnedPrimitives.insert(m_BinnedPrimitives.end(), perThreadBin.begin(), perThreadBin.end());
+            }
 
-                                    LOG("Tile %d block (%d, %d) TA'd by thread %d\n", nextTileIdx, bx, by, m_ThreadIdx);
+            return;
+        }
 
-                                    CoverageMask mask;
-                                    mask.m_SampleX = static_cast<uint32_t>(firstBlockWithinBBoxX + bxxOffset); // Based off of first block position calculated above
-                                    mask.m_SampleY = static_cast<uint32_t>(firstBlockWithinBBoxY + byyOffset); // Based off of first block position calculated above
-                                    mask.m_PrimIdx = primIdx;
-                                    mask.m_Type = CoverageMaskType::BLOCK;
+        // Each per-thread bin is sorted by primitive index, so per-thread bins are merged by appending the run of the bin with the lowest next primitive index
+        // until it reaches the next primitive index of any other bin, i.e. (at least) a whole batch of primitives fetched by a thread at a time
+        m_BinCursors.assign(perThreadBins.size(), 0u);
 
-                                    // Emit full-block coverage mask
-                                    m_pRenderEngine->AppendCoverageMask(
-                                        m_ThreadIdx,
-                                        nextTileIdx,
-                                        mask);
-                                }
-                                else
-                                {
-                                    // Overlap
-                                    // Block is partially covered by the triangle, descend into pixel level and perform edge tests
+        while (true)
+        {
+            uint32_t nextThreadIdx = UINT32_MAX;
+            uint32_t nextPrimIdx = UINT32_MAX;
+            uint32_t runEndPrimIdx = UINT32_MAX;
 
-                                    LOG("Tile %d block (%d, %d) overlapping tests by thread %d\n", nextTileIdx, bx, by, m_ThreadIdx);
+            for (uint32_t i = 0; i < perThreadBins.size(); i++)
+            {
+                if (m_BinCursors[i] < perThreadBins[i].size())
+                {
+                    const uint32_t primIdx = perThreadBins[i][m_BinCursors[i]] & ~g_scBinnedPrimTrivialAcceptFlag;
+                    if (primIdx < nextPrimIdx)
+                    {
+                        runEndPrimIdx = nextPrimIdx;
+                        nextPrimIdx = primIdx;
+                        nextThreadIdx = i;
+                    }
+                    else if (primIdx < runEndPrimIdx)
+                    {
+                        runEndPrimIdx = primIdx;
+                    }
+                }
+            }
 
-                                    // Position of the block that we're testing at pixel level
-                                    float blockPosX = (firstBlockWithinBBoxX + bxxOffset);
-                                    float blockPosY = (firstBlockWithinBBoxY + byyOffset);
+            if (nextThreadIdx == UINT32_MAX)
+            {
+                // All bins are consumed
+                break;
+            }
 
-                                    // Compute E(x, y) = (x * a) + (y * b) c at block origin once
-                                    __m128 sseEdge0FuncAtBlockOrigin = _mm_set1_ps(ee0.z + ((ee0.x * blockPosX) + (ee0.y * blockPosY)));
-                                    __m128 sseEdge1FuncAtBlockOrigin = _mm_set1_ps(ee1.z + ((ee1.x * blockPosX) + (ee1.y * blockPosY)));
-                                    __m128 sseEdge2FuncAtBlockOrigin = _mm_set1_ps(ee2.z + ((ee2.x * blockPosX) + (ee2.y * blockPosY)));
+            const std::vector<uint32_t>& perThreadBin = perThreadBins[nextThreadIdx];
+            uint32_t& binCursor = m_BinCursors[nextThreadIdx];
 
-                                    // Store edge 0 equation coefficients
-                                    __m128 sseEdge0A4 = _mm_set_ps1(ee0.x);
-                                    __m128 sseEdge0B4 = _mm_set_ps1(ee0.y);
+            do
+            {
+                m_BinnedPrimitives.push_back(perThreadBin[binCursor++]);
+            } while ((binCursor < perThreadBin.size()) && ((perThreadBin[binCursor] & ~g_scBinnedPrimTrivialAcceptFlag) < runEndPrimIdx));
+        }
+    }
 
-                                    // Store edge 1 equation coefficients
-                                    __m128 sseEdge1A4 = _mm_set_ps1(ee1.x);
-                                    __m128 sseEdge1B4 = _mm_set_ps1(ee1.y);
+    void PipelineThread::RasterizePrimitive(uint32_t tileIdx, uint32_t primIdx, CoverageMaskBuffer* pCoverageMaskBuffer)
+    {
+        ASSERT(pCoverageMaskBuffer != nullptr);
 
-                                    // Store edge 2 equation coefficients
-                                    __m128 sseEdge2A4 = _mm_set_ps1(ee2.x);
-                                    __m128 sseEdge2B4 = _mm_set_ps1(ee2.y);
+        // Tile origin
+        const float tilePosX = m_pRenderEngine->m_TileList[tileIdx].m_PosX;
+        const float tilePosY = m_pRenderEngine->m_TileList[tileIdx].m_PosY;
 
-                                    // Generate masks used for tie-breaking rules (not to double-shade along shared edges)
-                                    __m128 sseEdge0A4PositiveOrB4NonNegativeA4Zero = _mm_or_ps(_mm_cmpgt_ps(sseEdge0A4, _mm_setzero_ps()),
-                                        _mm_and_ps(_mm_cmpge_ps(sseEdge0B4, _mm_setzero_ps()), _mm_cmpeq_ps(sseEdge0A4, _mm_setzero_ps())));
+        if (primIdx & g_scBinnedPrimTrivialAcceptFlag)
+        {
+            // Tile is completely inside of the triangle, whole tile will be fragment-shaded
+            CoverageMask mask;
+            mask.m_SampleX = static_cast<uint32_t>(tilePosX);
+            mask.m_SampleY = static_cast<uint32_t>(tilePosY);
+            mask.m_PrimIdx = primIdx & ~g_scBinnedPrimTrivialAcceptFlag;
+            mask.m_Type = CoverageMaskType::TILE;
 
-                                    __m128 sseEdge1A4PositiveOrB4NonNegativeA4Zero = _mm_or_ps(_mm_cmpgt_ps(sseEdge1A4, _mm_setzero_ps()),
-                                        _mm_and_ps(_mm_cmpge_ps(sseEdge1B4, _mm_setzero_ps()), _mm_cmpeq_ps(sseEdge1A4, _mm_setzero_ps())));
+            pCoverageMaskBuffer->AppendCoverageMask(mask);
+            pCoverageMaskBuffer->IncreaseCapacityIfNeeded();
 
-                                    __m128 sseEdge2A4PositiveOrB4NonNegativeA4Zero = _mm_or_ps(_mm_cmpgt_ps(sseEdge2A4, _mm_setzero_ps()),
-                                        _mm_and_ps(_mm_cmpge_ps(sseEdge2B4, _mm_setzero_ps()), _mm_cmpeq_ps(sseEdge2A4, _mm_setzero_ps())));
+            return;
+        }
 
-                                    for (uint32_t py = 0; py < g_scPixelBlockSize; py++)
-                                    {
-                                        // Store Y positions in current row (all samples on the same row has the same Y position)
-                                        __m128 sseY4 = _mm_set_ps1(py + 0.5f);
+        // Copy prim's bbox to clamp it to the tile (or sub-tile) edges
+        Rect2D bbox = m_pDrawIteration->m_SetupBuffers.m_pPrimBBoxes[primIdx];
+        bbox.m_MinX = glm::max(bbox.m_MinX, tilePosX);
+        bbox.m_MinY = glm::max(bbox.m_MinY, static_cast<float>(m_SubTileMinY));
+        bbox.m_MaxX = glm::min(bbox.m_MaxX, tilePosX + m_RenderConfig.m_TileSize);
+        bbox.m_MaxY = glm::min(bbox.m_MaxY, static_cast<float>(m_SubTileMaxY));
 
-                                        for (uint32_t px = 0; px < g_scNumEdgeTestsPerRow; px++)
-                                        {
-                                            // E(x, y) = (x * a) + (y * b) + c
-                                            // E(x + s, y + t) = E(x, y) + s * a + t * b
+        if (bbox.m_MinY > bbox.m_MaxY)
+        {
+            // Primitive is binned for the tile but doesn't overlap the active sub-tile
+            return;
+        }
 
-#ifdef _DEBUG
-                                            int32_t debugMaskScalar = 0;
-                                            {
-                                                // Debug for SSE edge tests
-
-                                                float edge0FuncAtBlockOrigin = ee0.z + (ee0.x * blockPosX) + (ee0.y * blockPosY);
-                                                float edge1FuncAtBlockOrigin = ee1.z + (ee1.x * blockPosX) + (ee1.y * blockPosY);
-                                                float edge2FuncAtBlockOrigin = ee2.z + (ee2.x * blockPosX) + (ee2.y * blockPosY);
-
-                                                // 4 Sample locations
-                                                glm::vec2 sample0 = { g_scSIMDWidth * px + 0.5f, py + 0.5f };
-                                                glm::vec2 sample1 = { g_scSIMDWidth * px + 1.5f, py + 0.5f };
-                                                glm::vec2 sample2 = { g_scSIMDWidth * px + 2.5f, py + 0.5f };
-                                                glm::vec2 sample3 = { g_scSIMDWidth * px + 3.5f, py + 0.5f };
-
-                                                bool inside0 =
-                                                    EvaluateEdgeFunctionIncremental(ee0, sample0, edge0FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee1, sample0, edge1FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee2, sample0, edge2FuncAtBlockOrigin);
-
-                                                bool inside1 =
-                                                    EvaluateEdgeFunctionIncremental(ee0, sample1, edge0FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee1, sample1, edge1FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee2, sample1, edge2FuncAtBlockOrigin);
-
-                                                bool inside2 =
-                                                    EvaluateEdgeFunctionIncremental(ee0, sample2, edge0FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee1, sample2, edge1FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee2, sample2, edge2FuncAtBlockOrigin);
-
-                                                bool inside3 =
-                                                    EvaluateEdgeFunctionIncremental(ee0, sample3, edge0FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee1, sample3, edge1FuncAtBlockOrigin) &&
-                                                    EvaluateEdgeFunctionIncremental(ee2, sample3, edge2FuncAtBlockOrigin);
-
-                                                if (inside0) debugMaskScalar |= g_scQuadMask0;
-                                                if (inside1) debugMaskScalar |= g_scQuadMask1;
-                                                if (inside2) debugMaskScalar |= g_scQuadMask2;
-                                                if (inside3) debugMaskScalar |= g_scQuadMask3;
-                                            }
-#endif
+        // In case bbox is screwed up after clamping to the tile edges
+        ASSERT((bbox.m_MinX <= bbox.m_MaxX) && (bbox.m_MinY <= bbox.m_MaxY));
 
-                                            // Store X positions of 4 consecutive samples
-                                            __m128 sseX4 = _mm_setr_ps(
-                                                g_scSIMDWidth * px + 0.5f,
-                                                g_scSIMDWidth * px + 1.5f,
-                                                g_scSIMDWidth * px + 2.5f,
-                                                g_scSIMDWidth * px + 3.5f);
+        // Given a fixed 8x8 block and tile size, find min/max range of the blocks that fall within bbox computed above
+        // which we're going to iterate over, in order to determine how blocks within tile are to be rasterized
 
-                                            // a * s
-                                            __m128 sseEdge0TermA = _mm_mul_ps(sseEdge0A4, sseX4);
-                                            __m128 sseEdge1TermA = _mm_mul_ps(sseEdge1A4, sseX4);
-                                            __m128 sseEdge2TermA = _mm_mul_ps(sseEdge2A4, sseX4);
+        // Use floor(), min indices are inclusive
+        uint32_t minBlockX = static_cast<uint32_t>(glm::floor((bbox.m_MinX - tilePosX) / g_scPixelBlockSize));
+        uint32_t minBlockY = static_cast<uint32_t>(glm::floor((bbox.m_MinY - tilePosY) / g_scPixelBlockSize));
 
-                                            // b * t
-                                            __m128 sseEdge0TermB = _mm_mul_ps(sseEdge0B4, sseY4);
-                                            __m128 sseEdge1TermB = _mm_mul_ps(sseEdge1B4, sseY4);
-                                            __m128 sseEdge2TermB = _mm_mul_ps(sseEdge2B4, sseY4);
+        // Use ceil(), max indices are exclusive
+        uint32_t maxBlockX = static_cast<uint32_t>(glm::ceil((bbox.m_MaxX - tilePosX) / g_scPixelBlockSize));
+        uint32_t maxBlockY = static_cast<uint32_t>(glm::ceil((bbox.m_MaxY - tilePosY) / g_scPixelBlockSize));
 
-                                            // E(x+s, y+t) = E(x,y) + a*s + t*b
-                                            __m128 sseEdgeFunc0 = _mm_add_ps(sseEdge0FuncAtBlockOrigin, _mm_add_ps(sseEdge0TermA, sseEdge0TermB));
-                                            __m128 sseEdgeFunc1 = _mm_add_ps(sseEdge1FuncAtBlockOrigin, _mm_add_ps(sseEdge1TermA, sseEdge1TermB));
-                                            __m128 sseEdgeFunc2 = _mm_add_ps(sseEdge2FuncAtBlockOrigin, _mm_add_ps(sseEdge2TermA, sseEdge2TermB));
+        ASSERT((minBlockX <= maxBlockX) && (maxBlockX <= m_RenderConfig.m_TileSize / g_scPixelBlockSize));
+        ASSERT((minBlockY <= maxBlockY) && (maxBlockY <= m_RenderConfig.m_TileSize / g_scPixelBlockSize));
 
-#ifdef EDGE_TEST_SHARED_EDGES
-                                            //E(x, y):
-                                            //    E(x, y) > 0
-                                            //        ||
-                                            //    !E(x, y) < 0 && (a > 0 || (a = 0 && b >= 0))
-                                            //
-
-                                            // Edge 0 test
-                                            __m128 sseEdge0Positive = _mm_cmpgt_ps(sseEdgeFunc0, _mm_setzero_ps());
-                                            __m128 sseEdge0Negative = _mm_cmplt_ps(sseEdgeFunc0, _mm_setzero_ps());
-                                            __m128 sseEdge0FuncMask = _mm_or_ps(sseEdge0Positive,
-                                                _mm_andnot_ps(sseEdge0Negative, sseEdge0A4PositiveOrB4NonNegativeA4Zero));
-
-                                            // Edge 1 test
-                                            __m128 sseEdge1Positive = _mm_cmpgt_ps(sseEdgeFunc1, _mm_setzero_ps());
-                                            __m128 sseEdge1Negative = _mm_cmplt_ps(sseEdgeFunc1, _mm_setzero_ps());
-                                            __m128 sseEdge1FuncMask = _mm_or_ps(sseEdge1Positive,
-                                                _mm_andnot_ps(sseEdge1Negative, sseEdge1A4PositiveOrB4NonNegativeA4Zero));
-
-                                            // Edge 2 test
-                                            __m128 sseEdge2Positive = _mm_cmpgt_ps(sseEdgeFunc2, _mm_setzero_ps());
-                                            __m128 sseEdge2Negative = _mm_cmplt_ps(sseEdgeFunc2, _mm_setzero_ps());
-                                            __m128 sseEdge2FuncMask = _mm_or_ps(sseEdge2Positive,
-                                                _mm_andnot_ps(sseEdge2Negative, sseEdge2A4PositiveOrB4NonNegativeA4Zero));
-#else
-                                            // E(x, y): E(x, y) >= 0
+        // Use EE coefficients calculated in TriangleSetup again to rasterize primitive at the 8x8 block level
+        glm::vec3 ee0 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0];
+        glm::vec3 ee1 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1];
+        glm::vec3 ee2 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2];
 
-                                            __m128 sseEdge0FuncMask = _mm_cmpge_ps(sseEdgeFunc0, _mm_setzero_ps());
-                                            __m128 sseEdge1FuncMask = _mm_cmpge_ps(sseEdgeFunc1, _mm_setzero_ps());
-                                            __m128 sseEdge2FuncMask = _mm_cmpge_ps(sseEdgeFunc2, _mm_setzero_ps());
-#endif
-                                            // Combine resulting masks of all three edges
-                                            __m128 sseEdgeFuncResult = _mm_and_ps(sseEdge0FuncMask,
-                                                _mm_and_ps(sseEdge1FuncMask, sseEdge2FuncMask));
+        // Normalize edge functions
+        ee0 /= (glm::abs(ee0.x) + glm::abs(ee0.y));
+        ee1 /= (glm::abs(ee1.x) + glm::abs(ee1.y));
+        ee2 /= (glm::abs(ee2.x) + glm::abs(ee2.y));
 
-                                            uint16_t maskInt = static_cast<uint16_t>(_mm_movemask_ps(sseEdgeFuncResult));
+        static constexpr glm::vec2 scBlockCornerOffsets[] =
+        {
+            { 0.f, 0.f},                                // LL (origin)
+            { g_scPixelBlockSize, 0.f },                // LR
+            { 0.f, g_scPixelBlockSize },                // UL
+            { g_scPixelBlockSize, g_scPixelBlockSize}   // UR
+        };
 
-#ifdef _DEBUG
-                                            // Edge functions were computed incorrectly if that fires!!!
-                                            ASSERT(maskInt == debugMaskScalar);
-#endif
+        // (x, y) -> sample location | (a, b, c) -> edge equation coefficients
+        // E(x, y) = (a * x) + (b * y) + c
+        // E(x + s, y + t) = E(x, y) + (a * s) + (b * t)
 
-                                            // If at least one sample is visible, emit coverage mask for the tile
-                                            if (maskInt != 0x0)
-                                            {
-                                                // Quad mask points to the first sample
-                                                CoverageMask mask;
-                                                mask.m_SampleX = static_cast<uint32_t>(blockPosX + (g_scSIMDWidth * px));
-                                                mask.m_SampleY = static_cast<uint32_t>(blockPosY + py);
-                                                mask.m_PrimIdx = primIdx;
-                                                mask.m_Type = CoverageMaskType::QUAD;
-                                                mask.m_QuadMask = maskInt;
-
-                                                // Emit a quad mask
-                                                m_pRenderEngine->AppendCoverageMask(m_ThreadIdx, nextTileIdx, mask);
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
+        // Based on edge normal n=(a, b), set up block TR corners for each edge once
+        const uint8_t edge0TRCorner = (ee0.y >= 0.f) ? ((ee0.x >= 0.f) ? 3u : 2u) : (ee0.x >= 0.f) ? 1u : 0u;
+        const uint8_t edge1TRCorner = (ee1.y >= 0.f) ? ((ee1.x >= 0.f) ? 3u : 2u) : (ee1.x >= 0.f) ? 1u : 0u;
+        const uint8_t edge2TRCorner = (ee2.y >= 0.f) ? ((ee2.x >= 0.f) ? 3u : 2u) : (ee2.x >= 0.f) ? 1u : 0u;
 
-                    // Allocate space for more coverage masks, if needed
-                    m_pRenderEngine->ResizeCoverageMaskBuffer(m_ThreadIdx, nextTileIdx);
-                }
-            }
-        }
-    }
+        const uint8_t edge0TACorner = 3u - edge0TRCorner;
+        const uint8_t edge1TACorner = 3u - edge1TRCorner;
+        const uint8_t edge2TACorner = 3u - edge2TRCorner;
 
-    void PipelineThread::ExecuteFragmentShader()
-    {
-        uint32_t nextTileIdx;
-        while ((nextTileIdx = m_pRenderEngine->FetchNextTileForFragmentShading()) != g_scInvalidTileIndex)
-        {
-            ASSERT(nextTileIdx < (m_pRenderEngine->m_NumTilePerRow * m_pRenderEngine->m_NumTilePerColumn));
+        // Store edge 0 equation coefficients
+        __m128 sseEdge0A4 = _mm_set_ps1(ee0.x);
+        __m128 sseEdge0B4 = _mm_set_ps1(ee0.y);
 
-            // Fragment-shade visible samples consuming coverage masks emitted previously by the rasterizer stage
+        // Store edge 1 equation coefficients
+        __m128 sseEdge1A4 = _mm_set_ps1(ee1.x);
+        __m128 sseEdge1B4 = _mm_set_ps1(ee1.y);
 
-            // Get per-thread coverage mask and process them in order
-            for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
-            {
-                CoverageMaskBuffer* pCoverageMaskBuffer = m_pRenderEngine->m_CoverageMasks[nextTileIdx][i];
-                ASSERT(pCoverageMaskBuffer != nullptr);
-                ASSERT(pCoverageMaskBuffer->m_NumAllocations > 0);
+        // Store edge 2 equation coefficients
+        __m128 sseEdge2A4 = _mm_set_ps1(ee2.x);
+        __m128 sseEdge2B4 = _mm_set_ps1(ee2.y);
 
-                for (uint32_t numAlloc = 0; numAlloc < pCoverageMaskBuffer->m_NumAllocations; numAlloc++)
-                {
-                    auto& currentSlot = pCoverageMaskBuffer->m_AllocationList[numAlloc];
+        // Generate masks used for tie-breaking rules (not to double-shade along shared edges)
+        __m128 sseEdge0A4PositiveOrB4NonNegativeA4Zero = _mm_or_ps(_mm_cmpgt_ps(sseEdge0A4, _mm_setzero_ps()),
+            _mm_and_ps(_mm_cmpge_ps(sseEdge0B4, _mm_setzero_ps()), _mm_cmpeq_ps(sseEdge0A4, _mm_setzero_ps())));
 
-                    for (uint32_t numMask = 0; numMask < currentSlot.m_AllocationCount; numMask++)
-                    {
-                        ASSERT(pCoverageMaskBuffer->m_AllocationList[numAlloc].m_pData != nullptr);
+        __m128 sseEdge1A4PositiveOrB4NonNegativeA4Zero = _mm_or_ps(_mm_cmpgt_ps(sseEdge1A4, _mm_setzero_ps()),
+            _mm_and_ps(_mm_cmpge_ps(sseEdge1B4, _mm_setzero_ps()), _mm_cmpeq_ps(sseEdge1A4, _mm_setzero_ps())));
 
-                        CoverageMask* pMask = &currentSlot.m_pData[numMask];
+        __m128 sseEdge2A4PositiveOrB4NonNegativeA4Zero = _mm_or_ps(_mm_cmpgt_ps(sseEdge2A4, _mm_setzero_ps()),
+            _mm_and_ps(_mm_cmpge_ps(sseEdge2B4, _mm_setzero_ps()), _mm_cmpeq_ps(sseEdge2A4, _mm_setzero_ps())));
 
-                        // In many cases, next N coverage masks will have been generated for the same primitive
-                        // that we're fragment-shading at tile, block or fragment levels here,
-                        // it could be optimized so that the EE coefficients of the same primitive won't be fetched
-                        // from memory over and over again, unsure what gain, if anything it'd yield...
+        // Set up forward-differencing step vectors once per primitive so that edge functions
+        // can be evaluated with additions only while descending into pixel level below:
+        // E(x + s + 0.5, y + t + 0.5) = E(x, y) + a * (s + 0.5) + b * (t + 0.5) for the samples of a SIMD group
+        __m128 sseSampleOffsetsX4 = _mm_add_ps(_mm_loadu_ps(g_scSampleGroupOffsets.m_X), _mm_set_ps1(0.5f));
+        __m128 sseSampleOffsetsY4 = _mm_add_ps(_mm_loadu_ps(g_scSampleGroupOffsets.m_Y), _mm_set_ps1(0.5f));
 
-                        // First fetch EE coefficients that will be used (in addition to edge in/out tests) for perspective-correct interpolation of vertex attributes
-                        const glm::vec3 ee0 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * pMask->m_PrimIdx + 0];
-                        const glm::vec3 ee1 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * pMask->m_PrimIdx + 1];
-                        const glm::vec3 ee2 = m_pRenderEngine->m_SetupBuffers.m_pEdgeCoefficients[3 * pMask->m_PrimIdx + 2];
+        __m128 sseEdge0SampleOffsets = _mm_add_ps(_mm_mul_ps(sseEdge0A4, sseSampleOffsetsX4), _mm_mul_ps(sseEdge0B4, sseSampleOffsetsY4));
+        __m128 sseEdge1SampleOffsets = _mm_add_ps(_mm_mul_ps(sseEdge1A4, sseSampleOffsetsX4), _mm_mul_ps(sseEdge1B4, sseSampleOffsetsY4));
+        __m128 sseEdge2SampleOffsets = _mm_add_ps(_mm_mul_ps(sseEdge2A4, sseSampleOffsetsX4), _mm_mul_ps(sseEdge2B4, sseSampleOffsetsY4));
 
-                        // Store edge 0 coefficients
-                        __m128 sseA4Edge0 = _mm_set_ps1(ee0.x);
-                        __m128 sseB4Edge0 = _mm_set_ps1(ee0.y);
-                        __m128 sseC4Edge0 = _mm_set_ps1(ee0.z);
+        // E(x + w, y) = E(x, y) + a * w -> step to next group of samples in a row
+        __m128 sseEdge0ColumnStep = _mm_mul_ps(sseEdge0A4, _mm_set_ps1(static_cast<float>(g_scSampleGroupWidth)));
+        __m128 sseEdge1ColumnStep = _mm_mul_ps(sseEdge1A4, _mm_set_ps1(static_cast<float>(g_scSampleGroupWidth)));
+        __m128 sseEdge2ColumnStep = _mm_mul_ps(sseEdge2A4, _mm_set_ps1(static_cast<float>(g_scSampleGroupWidth)));
 
-                        // Store edge 1 equation coefficients
-                        __m128 sseA4Edge1 = _mm_set_ps1(ee1.x);
-                        __m128 sseB4Edge1 = _mm_set_ps1(ee1.y);
-                        __m128 sseC4Edge1 = _mm_set_ps1(ee1.z);
+        // E(x, y + h) = E(x, y) + b * h -> step to next row of sample groups
+        __m128 sseEdge0RowStep = _mm_mul_ps(sseEdge0B4, _mm_set_ps1(static_cast<float>(g_scSampleGroupHeight)));
+        __m128 sseEdge1RowStep = _mm_mul_ps(sseEdge1B4, _mm_set_ps1(static_cast<float>(g_scSampleGroupHeight)));
+        __m128 sseEdge2RowStep = _mm_mul_ps(sseEdge2B4, _mm_set_ps1(static_cast<float>(g_scSampleGroupHeight)));
 
-                        // Store edge 2 equation coefficients
-                        __m128 sseA4Edge2 = _mm_set_ps1(ee2.x);
-                        __m128 sseB4Edge2 = _mm_set_ps1(ee2.y);
-                        __m128 sseC4Edge2 = _mm_set_ps1(ee2.z);
+        // Evaluate edge function for the first block within [minBlock, maxBlock] region
+        // once and re-use it by stepping from it within following nested loop
 
-                        const SIMDEdgeCoefficients simdEERegs =
-                        {
-                            sseA4Edge0,
-                            sseA4Edge1,
-                            sseA4Edge2,
-                            sseB4Edge0,
-                            sseB4Edge1,
-                            sseB4Edge2,
-                            sseC4Edge0,
-                            sseC4Edge1,
-                            sseC4Edge2,
-                        };
-
-                        switch (pMask->m_Type)
-                        {
-                        case CoverageMaskType::TILE:
-                            LOG("Thread %d fragment-shading tile %d\n", m_ThreadIdx, nextTileIdx);
-                            FragmentShadeTile(pMask->m_SampleX, pMask->m_SampleY, pMask->m_PrimIdx, simdEERegs);
-                            break;
-                        case CoverageMaskType::BLOCK:
-                            LOG("Thread %d fragment-shading blocks\n", m_ThreadIdx);
-                            FragmentShadeBlock(pMask->m_SampleX, pMask->m_SampleY, pMask->m_PrimIdx, simdEERegs);
-                            break;
-                        case CoverageMaskType::QUAD:
-                            LOG("Thread %d fragment-shading coverage masks\n", m_ThreadIdx, ee0, ee1, ee2);
-                            FragmentShadeQuad(pMask, simdEERegs);
-                            break;
-                        default:
-                            ASSERT(false);
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-    }
+        const float firstBlockWithinBBoxX = tilePosX + minBlockX * g_scPixelBlockSize;
+        const float firstBlockWithinBBoxY = tilePosY + minBlockY * g_scPixelBlockSize;
 
-    void PipelineThread::FragmentShadeTile(uint32_t tilePosX, uint32_t tilePosY, uint32_t primIdx, const SIMDEdgeCoefficients& simdEERegs)
-    {
-        const uint32_t numBlockInTile = m_RenderConfig.m_TileSize / g_scPixelBlockSize;
+        // Evaluate edge equation at first block origin
+        const float edgeFunc0 = ee0.z + ((ee0.x * firstBlockWithinBBoxX) + (ee0.y * firstBlockWithinBBoxY));
+        const float edgeFunc1 = ee1.z + ((ee1.x * firstBlockWithinBBoxX) + (ee1.y * firstBlockWithinBBoxY));
+        const float edgeFunc2 = ee2.z + ((ee2.x * firstBlockWithinBBoxX) + (ee2.y * firstBlockWithinBBoxY));
 
-        for (uint32_t py = 0; py < numBlockInTile; py++)
+        // Iterate over calculated range of blocks within the tile
+        for (uint32_t by = minBlockY, byy = 0; by < maxBlockY; by++, byy++)
         {
-            for (uint32_t px = 0; px < numBlockInTile; px++)
+            for (uint32_t bx = minBlockX, bxx = 0; bx < maxBlockX; bx++, bxx++)
             {
-                FragmentShadeBlock(
-                    tilePosX + px * g_scPixelBlockSize,
-                    tilePosY + py * g_scPixelBlockSize,
-                    primIdx,
-                    simdEERegs);
-            }
-        }
-    }
+                // Using EE coefficients calculated in TriangleSetup stage and positive half-space tests, determine one of three cases possible for each block:
+                // 1) TrivialReject -- block within tri's bbox does not intersect tri -> move on
+                // 2) TrivialAccept -- block within tri's bbox is completely within tri -> emit a full-block coverage mask
+                // 3) Overlap       -- block within tri's bbox intersects tri -> descend into block level to emit coverage masks at pixel granularity
 
-    void PipelineThread::FragmentShadeBlock(uint32_t blockPosX, uint32_t blockPosY, uint32_t primIdx, const SIMDEdgeCoefficients& simdEERegs)
-    {
-        FragmentShader FS = m_pRenderEngine->m_FragmentShader;
-        ASSERT(FS != nullptr);
-
-        // Temp storage for interpolated vertex attributes
-        InterpolatedAttributes interpolatedAttribs;
+                // (bxx, byy) = How many steps are done per dimension
+                const float bxxOffset = static_cast<float>(bxx * g_scPixelBlockSize);
+                const float byyOffset = static_cast<float>(byy * g_scPixelBlockSize);
 
-        // Parameter interpolation basis functions
-        __m128 ssef0XY, ssef1XY;
+                // Step down from edge function computed above for the first block in bbox
+                float edgeFuncTR0 = edgeFunc0 + ((ee0.x * (scBlockCornerOffsets[edge0TRCorner].x + bxxOffset)) + (ee0.y * (scBlockCornerOffsets[edge0TRCorner].y + byyOffset)));
+                float edgeFuncTR1 = edgeFunc1 + ((ee1.x * (scBlockCornerOffsets[edge1TRCorner].x + bxxOffset)) + (ee1.y * (scBlockCornerOffsets[edge1TRCorner].y + byyOffset)));
+                float edgeFuncTR2 = edgeFunc2 + ((ee2.x * (scBlockCornerOffsets[edge2TRCorner].x + bxxOffset)) + (ee2.y * (scBlockCornerOffsets[edge2TRCorner].y + byyOffset)));
 
-        // 4-sample fragment colors
-        FragmentOutput fragmentOutput;
+                // If TR corner of the block is outside an edge, reject whole block
+                bool TRForEdge0 = (edgeFuncTR0 < 0.f);
+                bool TRForEdge1 = (edgeFuncTR1 < 0.f);
+                bool TRForEdge2 = (edgeFuncTR2 < 0.f);
+                if (TRForEdge0 || TRForEdge1 || TRForEdge2)
+                {
+                    LOG("Tile %d block (%d, %d) TR'd by thread %d\n", tileIdx, bx, by, m_ThreadIdx);
 
-        // Loop over 8x8 pixels
-        for (uint32_t py = 0; py < g_scPixelBlockSize; py++)
-        {
-            for (uint32_t px = 0; px < g_scNumEdgeTestsPerRow; px++)
-            {
-                uint32_t sampleX = blockPosX + (g_scSIMDWidth * px);
-                uint32_t sampleY = blockPosY + py;
+                    // TrivialReject
+                    // Block is completely outside of one or more edges
+                    continue;
+                }
+                else
+                {
+                    // Block is partially or completely inside one or more edges, do TrivialAccept tests first
 
-                // Calculate basis functions f0(x,y) & f1(x,y) once
-                ComputeParameterBasisFunctions(
-                    sampleX,
-                    sampleY,
-                    simdEERegs,
-                    &ssef0XY,
-                    &ssef1XY);
+                    // Compute edge functions at TA corners by stepping from first block position calculated above
+                    float edgeFuncTA0 = edgeFunc0 + ((ee0.x * (scBlockCornerOffsets[edge0TACorner].x + bxxOffset)) + (ee0.y * (scBlockCornerOffsets[edge0TACorner].y + byyOffset)));
+                    float edgeFuncTA1 = edgeFunc1 + ((ee1.x * (scBlockCornerOffsets[edge1TACorner].x + bxxOffset)) + (ee1.y * (scBlockCornerOffsets[edge1TACorner].y + byyOffset)));
+                    float edgeFuncTA2 = edgeFunc2 + ((ee2.x * (scBlockCornerOffsets[edge2TACorner].x + bxxOffset)) + (ee2.y * (scBlockCornerOffsets[edge2TACorner].y + byyOffset)));
 
-                // Interpolate Z (4 samples)
-                __m128 sseZInterpolated = InterpolateDepthValues(primIdx, ssef0XY, ssef1XY);
+                    // If TA corner of the block is inside all edges, accept whole block
+                    bool TAForEdge0 = (edgeFuncTA0 >= 0.f);
+                    bool TAForEdge1 = (edgeFuncTA1 >= 0.f);
+                    bool TAForEdge2 = (edgeFuncTA2 >= 0.f);
+                    if (TAForEdge0 && TAForEdge1 && TAForEdge2)
+                    {
+                        // TrivialAccept
+                        // Block is completely inside of the triangle, emit a full-block coverage mask
 
-                // Load current depth buffer contents
-                __m128 sseDepthCurrent = m_pRenderEngine->FetchDepthBuffer(sampleX, sampleY);
+                        LOG("Tile %d block (%d, %d) TA'd by thread %d\n", tileIdx, bx, by, m_ThreadIdx);
 
-                // Perform LESS_THAN_EQUAL depth test
-                __m128 sseDepthRes = _mm_cmple_ps(sseZInterpolated, sseDepthCurrent);
+                        CoverageMask mask;
+                        mask.m_SampleX = static_cast<uint32_t>(firstBlockWithinBBoxX + bxxOffset); // Based off of first block position calculated above
+                        mask.m_SampleY = static_cast<uint32_t>(firstBlockWithinBBoxY + byyOffset); // Based off of first block position calculated above
+                        mask.m_PrimIdx = primIdx;
+                        mask.m_Type = CoverageMaskType::BLOCK;
 
-                // Apply Early-Z test for block/tiles only!
-                if (_mm_movemask_ps(sseDepthRes) == 0x0)
-                {
-                    LOG("Prim %d killed in Early-Z optimization at (%d, %d) by thread %d\n", primIdx, sampleX, sampleY, m_ThreadIdx);
+                        // Emit full-block coverage mask
+                        pCoverageMaskBuffer->AppendCoverageMask(mask);
+                    }
+                    else
+                    {
+                        // Overlap
+                        // Block is partially covered by the triangle, descend into pixel level and perform edge tests
 
-                    // No sample being processed passes depth test, skip invoking FS altogether
-                    continue;
-                }
+                        LOG("Tile %d block (%d, %d) overlapping tests by thread %d\n", tileIdx, bx, by, m_ThreadIdx);
 
-                // Interpolate active vertex attributes
-                InterpolateVertexAttributes(primIdx, ssef0XY, ssef1XY, &interpolatedAttribs);
+                        // Position of the block that we're testing at pixel level
+                        float blockPosX = (firstBlockWithinBBoxX + bxxOffset);
+                        float blockPosY = (firstBlockWithinBBoxY + byyOffset);
 
-                // Invoke FS and update color/depth buffer with fragment output
-                FS(&interpolatedAttribs, m_pRenderEngine->m_pConstantBuffer, &fragmentOutput);
+                        // Compute E(x, y) = (x * a) + (y * b) + c at block origin once and offset it to the samples of first SIMD group
+                        __m128 sseEdge0FuncRow = _mm_add_ps(_mm_set1_ps(ee0.z + ((ee0.x * blockPosX) + (ee0.y * blockPosY))), sseEdge0SampleOffsets);
+                        __m128 sseEdge1FuncRow = _mm_add_ps(_mm_set1_ps(ee1.z + ((ee1.x * blockPosX) + (ee1.y * blockPosY))), sseEdge1SampleOffsets);
+                        __m128 sseEdge2FuncRow = _mm_add_ps(_mm_set1_ps(ee2.z + ((ee2.x * blockPosX) + (ee2.y * blockPosY))), sseEdge2SampleOffsets);
 
-                // Write interpolated Z values
-                m_pRenderEngine->UpdateDepthBuffer(sseDepthRes, sseZInterpolated, sampleX, sampleY);
+                        for (uint32_t py = 0; py < g_scPixelBlockSize; py += g_scSampleGroupHeight)
+                        {
+                            // Edge functions at first SIMD group of current row
+                            __m128 sseEdgeFunc0 = sseEdge0FuncRow;
+                            __m128 sseEdgeFunc1 = sseEdge1FuncRow;
+                            __m128 sseEdgeFunc2 = sseEdge2FuncRow;
 
-                // Write fragment output
-                m_pRenderEngine->UpdateColorBuffer(sseDepthRes, fragmentOutput, sampleX, sampleY);
-            }
-        }
-    }
+                            for (uint32_t px = 0; px < g_scPixelBlockSize; px += g_scSampleGroupWidth)
+                            {
+                                // E(x, y) = (x * a) + (y * b) + c
+                                // E(x + s, y + t) = E(x, y) + s * a + t * b
 
-    void PipelineThread::FragmentShadeQuad(CoverageMask* pMask, const SIMDEdgeCoefficients& simdEERegs)
-    {
-        ASSERT(pMask != nullptr);
+#ifdef _DEBUG
+                                int32_t debugMaskScalar = 0;
+                                {
+                                    // Debug for SSE edge tests
+
+                                    float edge0FuncAtBlockOrigin = ee0.z + (ee0.x * blockPosX) + (ee0.y * blockPosY);
+                                    float edge1FuncAtBlockOrigin = ee1.z + (ee1.x * blockPosX) + (ee1.y * blockPosY);
+                                    float edge2FuncAtBlockOrigin = ee2.z + (ee2.x * blockPosX) + (ee2.y * blockPosY);
+
+                                    // 4 Sample locations
+                                    glm::vec2 sample0 = { px + g_scSampleGroupOffsets.m_X[0] + 0.5f, py + g_scSampleGroupOffsets.m_Y[0] + 0.5f };
+                                    glm::vec2 sample1 = { px + g_scSampleGroupOffsets.m_X[1] + 0.5f, py + g_scSampleGroupOffsets.m_Y[1] + 0.5f };
+                                    glm::vec2 sample2 = { px + g_scSampleGroupOffsets.m_X[2] + 0.5f, py + g_scSampleGroupOffsets.m_Y[2] + 0.5f };
+                                    glm::vec2 sample3 = { px + g_scSampleGroupOffsets.m_X[3] + 0.5f, py + g_scSampleGroupOffsets.m_Y[3] + 0.5f };
+
+                                    bool inside0 =
+                                        EvaluateEdgeFunctionIncremental(ee0, sample0, edge0FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee1, sample0, edge1FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee2, sample0, edge2FuncAtBlockOrigin);
+
+                                    bool inside1 =
+                                        EvaluateEdgeFunctionIncremental(ee0, sample1, edge0FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee1, sample1, edge1FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee2, sample1, edge2FuncAtBlockOrigin);
+
+                                    bool inside2 =
+                                        EvaluateEdgeFunctionIncremental(ee0, sample2, edge0FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee1, sample2, edge1FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee2, sample2, edge2FuncAtBlockOrigin);
+
+                                    bool inside3 =
+                                        EvaluateEdgeFunctionIncremental(ee0, sample3, edge0FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee1, sample3, edge1FuncAtBlockOrigin) &&
+                                        EvaluateEdgeFunctionIncremental(ee2, sample3, edge2FuncAtBlockOrigin);
+
+                                    if (inside0) debugMaskScalar |= g_scQuadMask0;
+                                    if (inside1) debugMaskScalar |= g_scQuadMask1;
+                                    if (inside2) debugMaskScalar |= g_scQuadMask2;
+                                    if (inside3) debugMaskScalar |= g_scQuadMask3;
+                                }
+#endif
 
-        FragmentShader FS = m_pRenderEngine->m_FragmentShader;
-        ASSERT(FS != nullptr);
+#ifdef EDGE_TEST_SHARED_EDGES
+                                //E(x, y):
+                                //    E(x, y) > 0
+                                //        ||
+                                //    !E(x, y) < 0 && (a > 0 || (a = 0 && b >= 0))
+                                //
+
+                                // Edge 0 test
+                                __m128 sseEdge0Positive = _mm_cmpgt_ps(sseEdgeFunc0, _mm_setzero_ps());
+                                __m128 sseEdge0Negative = _mm_cmplt_ps(sseEdgeFunc0, _mm_setzero_ps());
+                                __m128 sseEdge0FuncMask = _mm_or_ps(sseEdge0Positive,
+                                    _mm_andnot_ps(sseEdge0Negative, sseEdge0A4PositiveOrB4NonNegativeA4Zero));
+
+                                // Edge 1 test
+                                __m128 sseEdge1Positive = _mm_cmpgt_ps(sseEdgeFunc1, _mm_setzero_ps());
+                                __m128 sseEdge1Negative = _mm_cmplt_ps(sseEdgeFunc1, _mm_setzero_ps());
+                                __m128 sseEdge1FuncMask = _mm_or_ps(sseEdge1Positive,
+                                    _mm_andnot_ps(sseEdge1Negative, sseEdge1A4PositiveOrB4NonNegativeA4Zero));
+
+                                // Edge 2 test
+                                __m128 sseEdge2Positive = _mm_cmpgt_ps(sseEdgeFunc2, _mm_setzero_ps());
+                                __m128 sseEdge2Negative = _mm_cmplt_ps(sseEdgeFunc2, _mm_setzero_ps());
+                                __m128 sseEdge2FuncMask = _mm_or_ps(sseEdge2Positive,
+                                    _mm_andnot_ps(sseEdge2Negative, sseEdge2A4PositiveOrB4NonNegativeA4Zero));
+#else
+                                // E(x, y): E(x, y) >= 0
 
-        // Vertex attributes to be interpolated and passed to FS
-        InterpolatedAttributes interpolatedAttribs;
+                                __m128 sseEdge0FuncMask = _mm_cmpge_ps(sseEdgeFunc0, _mm_setzero_ps());
+                                __m128 sseEdge1FuncMask = _mm_cmpge_ps(sseEdgeFunc1, _mm_setzero_ps());
+                                __m128 sseEdge2FuncMask = _mm_cmpge_ps(sseEdgeFunc2, _mm_setzero_ps());
+#endif
+                                // Combine resulting masks of all three edges
+                                __m128 sseEdgeFuncResult = _mm_and_ps(sseEdge0FuncMask,
+                                    _mm_and_ps(sseEdge1FuncMask, sseEdge2FuncMask));
 
-        // Parameter interpolation basis functions
-        __m128 ssef0XY, ssef1XY;
+                                uint16_t maskInt = static_cast<uint16_t>(_mm_movemask_ps(sseEdgeFuncResult));
 
-        // Calculate basis functions f0(x,y) & f1(x,y) once
-        ComputeParameterBasisFunctions(
-            pMask->m_SampleX,
-            pMask->m_SampleY,
-            simdEERegs,            
-            &ssef0XY,
-            &ssef1XY);
+#ifdef _DEBUG
+                                // Edge functions were computed incorrectly if that fires!!!
+                                ASSERT(maskInt == debugMaskScalar);
+#endif
 
-        // Interpolate depth values prior to depth test
-        __m128 sseZInterpolated = InterpolateDepthValues(pMask->m_PrimIdx, ssef0XY, ssef1XY);
+                                // If at least one sample is visible, emit coverage mask for the tile
+                                if (maskInt != 0x0)
+                                {
+                                    // Quad mask points to the first sample
+                                    CoverageMask mask;
+                                    mask.m_SampleX = static_cast<uint32_t>(blockPosX + px);
+                                    mask.m_SampleY = static_cast<uint32_t>(blockPosY + py);
+                                    mask.m_PrimIdx = primIdx;
+                                    mask.m_Type = CoverageMaskType::QUAD;
+                                    mask.m_QuadMask = maskInt;
 
-        // Load current depth buffer contents
-        __m128 sseDepthCurrent = m_pRenderEngine->FetchDepthBuffer(pMask->m_SampleX, pMask->m_SampleY);
+                                    // Emit a quad mask
+                                    pCoverageMaskBuffer->AppendCoverageMask(mask);
+                                }
 
-        // Perform LESS_THAN_EQUAL depth test
-        __m128 sseDepthRes = _mm_cmple_ps(sseZInterpolated, sseDepthCurrent);
+                                // Step to next SIMD group in current row
+                                sseEdgeFunc0 = _mm_add_ps(sseEdgeFunc0, sseEdge0ColumnStep);
+                                sseEdgeFunc1 = _mm_add_ps(sseEdgeFunc1, sseEdge1ColumnStep);
+                                sseEdgeFunc2 = _mm_add_ps(sseEdgeFunc2, sseEdge2ColumnStep);
+                            }
 
-        // Interpolate active vertex attributes
-        InterpolateVertexAttributes(pMask->m_PrimIdx, ssef0XY, ssef1XY, &interpolatedAttribs);
+                            // Step to next row of SIMD groups
+                            sseEdge0FuncRow = _mm_add_ps(sseEdge0FuncRow, sseEdge0RowStep);
+                            sseEdge1FuncRow = _mm_add_ps(sseEdge1FuncRow, sseEdge1RowStep);
+                            sseEdge2FuncRow = _mm_add_ps(sseEdge2FuncRow, sseEdge2RowStep);
+                        }
+                    }
+                }
+            }
+        }
 
-        // 4-sample fragment colors
-        FragmentOutput fragmentOutput;
+        // Allocate space for more coverage masks, if needed
+        pCoverageMaskBuffer->IncreaseCapacityIfNeeded();
+    }
 
-        // Invoke FS and update color/depth buffer with fragment output
-        FS(&interpolatedAttribs, m_pRenderEngine->m_pConstantBuffer, &fragmentOutput);
+    void PipelineThread::FetchSubpassInput(uint32_t sampleX, uint32_t sampleY, InterpolatedAttributes* pInterpolatedAttributes)
+    {
+        // Color & depth at the samples, from tile buffers if enabled
+        m_pRenderEngine->FetchColorBuffer(sampleX, sampleY, pInterpolatedAttributes->m_SubpassInputColors);
+        pInterpolatedAttributes->m_SubpassInputDepth = m_pRenderEngine->FetchDepthBuffer(sampleX, sampleY);
+    }
 
-        // Generate color mask from 4-bit int mask set during rasterization
-        __m128i sseColorMask = _mm_setr_epi32(
-            pMask->m_QuadMask & g_scQuadMask0,
-            pMask->m_QuadMask & g_scQuadMask1,
-            pMask->m_QuadMask & g_scQuadMask2,
-            pMask->m_QuadMask & g_scQuadMask3);
+    void PipelineThread::LoadBlockFragmentOutput(uint32_t sampleGroupIdx, FragmentOutput* pFragmentOutput) const
+    {
+        ASSERT(sampleGroupIdx < g_scNumSampleGroupsPerBlock);
+        ASSERT(pFragmentOutput != nullptr);
 
-        sseColorMask = _mm_cmpeq_epi32(sseColorMask,
-            _mm_set_epi64x(0x800000004, 0x200000001));
+        const uint32_t offset = sampleGroupIdx * g_scSIMDWidth;
 
-        // AND depth mask & coverage mask for quads of fragments
-        __m128 sseWriteMask = _mm_and_ps(sseDepthRes, _mm_castsi128_ps(sseColorMask));
+        __m128 sseR = _mm_load_ps(&m_BlockFragmentOutput.m_R[offset]);
+        __m128 sseG = _mm_load_ps(&m_BlockFragmentOutput.m_G[offset]);
+        __m128 sseB = _mm_load_ps(&m_BlockFragmentOutput.m_B[offset]);
+        __m128 sseA = _mm_load_ps(&m_BlockFragmentOutput.m_A[offset]);
 
-        // Write interpolated Z values
-        m_pRenderEngine->UpdateDepthBuffer(sseWriteMask, sseZInterpolated, pMask->m_SampleX, pMask->m_SampleY);
+        // SoA -> per-sample RGBA
+        _MM_TRANSPOSE4_PS(sseR, sseG, sseB, sseA);
 
-        // Write fragment output
-        m_pRenderEngine->UpdateColorBuffer(sseWriteMask, fragmentOutput, pMask->m_SampleX, pMask->m_SampleY);
+        pFragmentOutput->m_FragmentColors[0] = sseR;
+        pFragmentOutput->m_FragmentColors[1] = sseG;
+        pFragmentOutput->m_FragmentColors[2] = sseB;
+        pFragmentOutput->m_FragmentColors[3] = sseA;
     }
 
     Rect2D PipelineThread::ComputeBoundingBox(const glm::vec4& v0Clip, const glm::vec4& v1Clip, const glm::vec4& v2Clip, float width, float height) const
@@ -1319,247 +1225,89 @@ namespace tyler
         return bbox;
     }
 
-    void PipelineThread::CalculateInterpolationCoefficients(
-        uint32_t drawIDx,
-        const VertexAttributes& vertexAttribs0,
-        const VertexAttributes& vertexAttribs1,
-        const VertexAttributes& vertexAttribs2)
+    void PipelineThread::ComputeEdgeFunctionsAtSample(
+        uint32_t sampleX,
+        uint32_t sampleY,
+        const SIMDEdgeCoefficients& simdEERegs,
+        __m128* pSSEF0XY,
+        __m128* pSSEF1XY,
+        __m128* pSSEFXY)
     {
-        // f0 + f1 + f2 = 1
-        // f0 * x0 + f1 * x1 + f2 * x2 ==> f0 * (x0 - x2) + f1 * (x1 - x2) + x2
-
-        // vec4 attributes
-        for (uint32_t i = 0; i < m_pRenderEngine->m_ShaderMetadata.m_NumVec4Attributes; i++)
-        {
-            const glm::vec4& attrib0 = vertexAttribs0.m_Attributes4[i];
-            const glm::vec4& attrib1 = vertexAttribs1.m_Attributes4[i];
-            const glm::vec4& attrib2 = vertexAttribs2.m_Attributes4[i];
-
-            // Store computed deltas in setup buffers for vec4 xyzw attributes
-            m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 0] = glm::vec3((attrib0.x - attrib2.x), (attrib1.x - attrib2.x), attrib2.x);
-            m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 1] = glm::vec3((attrib0.y - attrib2.y), (attrib1.y - attrib2.y), attrib2.y);
-            m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 2] = glm::vec3((attrib0.z - attrib2.z), (attrib1.z - attrib2.z), attrib2.z);
-            m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 3] = glm::vec3((attrib0.w - attrib2.w), (attrib1.w - attrib2.w), attrib2.w);
-        }
-
-        // vec3 attributes
-        for (uint32_t i = 0; i < m_pRenderEngine->m_ShaderMetadata.m_NumVec3Attributes; i++)
-        {
-            const glm::vec3& attrib0 = vertexAttribs0.m_Attributes3[i];
-            const glm::vec3& attrib1 = vertexAttribs1.m_Attributes3[i];
-            const glm::vec3& attrib2 = vertexAttribs2.m_Attributes3[i];
-
-            // Store computed deltas in setup buffers for vec3 xyz attributes
-            m_pRenderEngine->m_SetupBuffers.m_Attribute3Deltas[i][drawIDx * 3 + 0] = glm::vec3((attrib0.x - attrib2.x), (attrib1.x - attrib2.x), attrib2.x);
-            m_pRenderEngine->m_SetupBuffers.m_Attribute3Deltas[i][drawIDx * 3 + 1] = glm::vec3((attrib0.y - attrib2.y), (attrib1.y - attrib2.y), attrib2.y);
-            m_pRenderEngine->m_SetupBuffers.m_Attribute3Deltas[i][drawIDx * 3 + 2] = glm::vec3((attrib0.z - attrib2.z), (attrib1.z - attrib2.z), attrib2.z);
-        }
-
-        // vec2 attributes
-        for (uint32_t i = 0; i < m_pRenderEngine->m_ShaderMetadata.m_NumVec2Attributes; i++)
-        {
-            const glm::vec2& attrib0 = vertexAttribs0.m_Attributes2[i];
-            const glm::vec2& attrib1 = vertexAttribs1.m_Attributes2[i];
-            const glm::vec2& attrib2 = vertexAttribs2.m_Attributes2[i];
-
-            // Store computed deltas in setup buffers for vec2 xy attributes
-            m_pRenderEngine->m_SetupBuffers.m_Attribute2Deltas[i][drawIDx * 2 + 0] = glm::vec3((attrib0.x - attrib2.x), (attrib1.x - attrib2.x), attrib2.x);
-            m_pRenderEngine->m_SetupBuffers.m_Attribute2Deltas[i][drawIDx * 2 + 1] = glm::vec3((attrib0.y - attrib2.y), (attrib1.y - attrib2.y), attrib2.y);
-        }
+        // Only evaluated once per block/quad, remaining SIMD groups will be reached by stepping from here
+        __m128 sseX4 = _mm_set_ps1(static_cast<float>(sampleX)); // x x x x
+        __m128 sseY4 = _mm_set_ps1(static_cast<float>(sampleY)); // y y y y
+
+        // Compute F0(x,y) and offset it to the samples of SIMD group
+        *pSSEF0XY = _mm_add_ps(
+            _mm_add_ps(simdEERegs.m_SSEC4Edge0,
+                _mm_add_ps(
+                    _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Edge0),
+                    _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Edge0))),
+            simdEERegs.m_SSEF0SampleOffsets);
+
+        // Compute F1(x,y) and offset it to the samples of SIMD group
+        *pSSEF1XY = _mm_add_ps(
+            _mm_add_ps(simdEERegs.m_SSEC4Edge1,
+                _mm_add_ps(
+                    _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Edge1),
+                    _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Edge1))),
+            simdEERegs.m_SSEF1SampleOffsets);
+
+        // Compute F(x,y) = F0(x,y) + F1(x,y) + F2(x,y) and offset it to the samples of SIMD group
+        *pSSEFXY = _mm_add_ps(
+            _mm_add_ps(simdEERegs.m_SSEC4Sum,
+                _mm_add_ps(
+                    _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Sum),
+                    _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Sum))),
+            simdEERegs.m_SSEFSampleOffsets);
     }
 
     void PipelineThread::ComputeParameterBasisFunctions(
-        uint32_t sampleX,
-        uint32_t sampleY,
-        const SIMDEdgeCoefficients& simdEERegs,
+        const __m128& sseF0XY,
+        const __m128& sseF1XY,
+        const __m128& sseFXY,
         __m128* pSSEf0XY,
         __m128* pSSEf1XY)
     {
         // R(x, y) = F0(x, y) + F1(x, y) + F2(x, y)
         // r = 1/(F0(x, y) + F1(x, y) + F2(x, y))
 
-        //TODO: Optimize w/ incremental F(x, y) evaluations!
-
-        // Store X positions of 4 consecutive samples
-        __m128 sseX4 = _mm_setr_ps(
-            sampleX + 0.5f,
-            sampleX + 1.5f,
-            sampleX + 2.5f,
-            sampleX + 3.5f); // x x+1 x+2 x+3
-
-        // Store Y positions of 4 samples in a row (constant)
-        __m128 sseY4 = _mm_set_ps1(sampleY); // y y y y
-
-        // Compute F0(x,y)
-        __m128 sseF0XY4 = _mm_add_ps(simdEERegs.m_SSEC4Edge0,
-            _mm_add_ps(
-                _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Edge0),
-                _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Edge0)));
-
-        // Compute F1(x,y)
-        __m128 sseF1XY4 = _mm_add_ps(simdEERegs.m_SSEC4Edge1,
-            _mm_add_ps(
-                _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Edge1),
-                _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Edge1)));
-
-        // Compute F2(x,y)
-        __m128 sseF2XY4 = _mm_add_ps(simdEERegs.m_SSEC4Edge2,
-            _mm_add_ps(
-                _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Edge2),
-                _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Edge2)));
-
-        // Compute F(x,y) = F0(x,y) + F1(x,y) + F2(x,y)
-        __m128 sseR4 = _mm_add_ps(sseF2XY4, _mm_add_ps(sseF0XY4, sseF1XY4));
-
         // Compute perspective correction factor
-        sseR4 = _mm_rcp_ps(sseR4);
+        __m128 sseR4 = _mm_rcp_ps(sseFXY);
 
         // Assign final f0(x,y) & f1(x,y)
-        *pSSEf0XY = _mm_mul_ps(sseR4, sseF0XY4);
-        *pSSEf1XY = _mm_mul_ps(sseR4, sseF1XY4);
+        *pSSEf0XY = _mm_mul_ps(sseR4, sseF0XY);
+        *pSSEf1XY = _mm_mul_ps(sseR4, sseF1XY);
 
         // Basis functions f0, f1, f2 sum to 1, e.g. f0(x,y) + f1(x,y) + f2(x,y) = 1 so we'll skip computing f2(x,y) explicitly
     }
 
-    __m128 PipelineThread::InterpolateDepthValues(uint32_t primIdx, const __m128& ssef0XY, const __m128& ssef1XY)
+    __m128 PipelineThread::ComputeDepthValuesAtSample(uint32_t sampleX, uint32_t sampleY, const SIMDEdgeCoefficients& simdEERegs)
     {
-        // Fetch interpolation deltas computed after VS was returned
-        const glm::vec3& attrib0Vec3 = m_pRenderEngine->m_SetupBuffers.m_pInterpolatedZValues[primIdx];
-
-        // vec3::x attribute to be interpolated
-        __m128 sseAttrib0 = _mm_set_ps1(attrib0Vec3.x);
-        __m128 sseAttrib1 = _mm_set_ps1(attrib0Vec3.y);
-        __m128 sseAttrib2 = _mm_set_ps1(attrib0Vec3.z);
-
-        return _mm_add_ps(sseAttrib2,
-            _mm_add_ps(_mm_mul_ps(sseAttrib0, ssef0XY),
-                _mm_mul_ps(sseAttrib1, ssef1XY)));
+        __m128 sseX4 = _mm_set_ps1(static_cast<float>(sampleX)); // x x x x
+        __m128 sseY4 = _mm_set_ps1(static_cast<float>(sampleY)); // y y y y
+
+        // Z(x,y) = (a * x) + (b * y) + c, offset to the samples of SIMD group
+        return _mm_add_ps(
+            _mm_add_ps(simdEERegs.m_SSEC4Depth,
+                _mm_add_ps(
+                    _mm_mul_ps(sseY4, simdEERegs.m_SSEB4Depth),
+                    _mm_mul_ps(sseX4, simdEERegs.m_SSEA4Depth))),
+            simdEERegs.m_SSEZSampleOffsets);
     }
 
-    void PipelineThread::InterpolateVertexAttributes(
-        uint32_t primIdx,
-        const __m128& ssef0XY,
-        const __m128& ssef1XY,
-        InterpolatedAttributes* pInterpolatedAttributes)
+    float PipelineThread::ComputeMinDepthValueInBlock(uint32_t blockPosX, uint32_t blockPosY, const SIMDEdgeCoefficients& simdEERegs)
     {
-        // vec4 xyzw attributes
-        for (uint32_t i = 0; i < m_pRenderEngine->m_ShaderMetadata.m_NumVec4Attributes; i++)
-        {
-            // Fetch interpolation deltas computed after VS was returned
-            const glm::vec3& attrib0Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 0];
-            const glm::vec3& attrib1Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 1];
-            const glm::vec3& attrib2Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 2];
-            const glm::vec3& attrib3Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 3];
-
-            // vec4::x attribute to be interpolated
-            __m128 sseAttrib0X = _mm_set_ps1(attrib0Vec3.x);
-            __m128 sseAttrib1X = _mm_set_ps1(attrib0Vec3.y);
-            __m128 sseAttrib2X = _mm_set_ps1(attrib0Vec3.z);
-
-            __m128 sseVec4AttribX = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0X, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1X, ssef1XY), sseAttrib2X));
-
-            // vec4::y attribute to be interpolated
-            __m128 sseAttrib0Y = _mm_set_ps1(attrib1Vec3.x);
-            __m128 sseAttrib1Y = _mm_set_ps1(attrib1Vec3.y);
-            __m128 sseAttrib2Y = _mm_set_ps1(attrib1Vec3.z);
-
-            __m128 sseVec4AttribY = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0Y, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1Y, ssef1XY), sseAttrib2Y));
-
-            // vec4::z attribute to be interpolated
-            __m128 sseAttrib0Z = _mm_set_ps1(attrib2Vec3.x);
-            __m128 sseAttrib1Z = _mm_set_ps1(attrib2Vec3.y);
-            __m128 sseAttrib2Z = _mm_set_ps1(attrib2Vec3.z);
-
-            __m128 sseVec4AttribZ = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0Z, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1Z, ssef1XY), sseAttrib2Z));
-
-            // vec4::w attribute to be interpolated
-            __m128 sseAttrib0W = _mm_set_ps1(attrib3Vec3.x);
-            __m128 sseAttrib1W = _mm_set_ps1(attrib3Vec3.y);
-            __m128 sseAttrib2W = _mm_set_ps1(attrib3Vec3.z);
-
-            __m128 sseVec3AttribW = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0W, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1W, ssef1XY), sseAttrib2W));
-
-            pInterpolatedAttributes[i].m_Vec4Attributes[i].m_SSEX = sseVec4AttribX;
-            pInterpolatedAttributes[i].m_Vec4Attributes[i].m_SSEY = sseVec4AttribY;
-            pInterpolatedAttributes[i].m_Vec4Attributes[i].m_SSEZ = sseVec4AttribZ;
-            pInterpolatedAttributes[i].m_Vec4Attributes[i].m_SSEW = sseVec3AttribW;
-        }
+        const float a = _mm_cvtss_f32(simdEERegs.m_SSEA4Depth);
+        const float b = _mm_cvtss_f32(simdEERegs.m_SSEB4Depth);
+        const float c = _mm_cvtss_f32(simdEERegs.m_SSEC4Depth);
 
-        // vec3 xyz attributes
-        for (uint32_t i = 0; i < m_pRenderEngine->m_ShaderMetadata.m_NumVec3Attributes; i++)
-        {
-            // Fetch interpolation deltas computed after VS was returned
-            const glm::vec3& attrib0Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute3Deltas[i][primIdx * 3 + 0];
-            const glm::vec3& attrib1Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute3Deltas[i][primIdx * 3 + 1];
-            const glm::vec3& attrib2Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute3Deltas[i][primIdx * 3 + 2];
-
-            // vec3::x attribute to be interpolated
-            __m128 sseAttrib0X = _mm_set_ps1(attrib0Vec3.x);
-            __m128 sseAttrib1X = _mm_set_ps1(attrib0Vec3.y);
-            __m128 sseAttrib2X = _mm_set_ps1(attrib0Vec3.z);
-
-            __m128 sseVec3AttribX = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0X, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1X, ssef1XY), sseAttrib2X));
-
-            // vec3::y attribute to be interpolated
-            __m128 sseAttrib0Y = _mm_set_ps1(attrib1Vec3.x);
-            __m128 sseAttrib1Y = _mm_set_ps1(attrib1Vec3.y);
-            __m128 sseAttrib2Y = _mm_set_ps1(attrib1Vec3.z);
-
-            __m128 sseVec3AttribY = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0Y, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1Y, ssef1XY), sseAttrib2Y));
-
-            // vec3::z attribute to be interpolated
-            __m128 sseAttrib0Z = _mm_set_ps1(attrib2Vec3.x);
-            __m128 sseAttrib1Z = _mm_set_ps1(attrib2Vec3.y);
-            __m128 sseAttrib2Z = _mm_set_ps1(attrib2Vec3.z);
-
-            __m128 sseVec3AttribZ = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0Z, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1Z, ssef1XY), sseAttrib2Z));
-
-            pInterpolatedAttributes[i].m_Vec3Attributes[i].m_SSEX = sseVec3AttribX;
-            pInterpolatedAttributes[i].m_Vec3Attributes[i].m_SSEY = sseVec3AttribY;
-            pInterpolatedAttributes[i].m_Vec3Attributes[i].m_SSEZ = sseVec3AttribZ;
-        }
+        // Z(x,y) is a plane so its min within the block is at one of the corner sample centers
+        const float xMin = static_cast<float>(blockPosX) + 0.5f;
+        const float xMax = xMin + static_cast<float>(g_scPixelBlockSize - 1);
+        const float yMin = static_cast<float>(blockPosY) + 0.5f;
+        const float yMax = yMin + static_cast<float>(g_scPixelBlockSize - 1);
 
-        // vec2 xy attributes
-        for (uint32_t i = 0; i < m_pRenderEngine->m_ShaderMetadata.m_NumVec2Attributes; i++)
-        {
-            // Fetch interpolation deltas computed after VS was returned
-            const glm::vec3& attrib0Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute2Deltas[i][primIdx * 2 + 0];
-            const glm::vec3& attrib1Vec3 = m_pRenderEngine->m_SetupBuffers.m_Attribute2Deltas[i][primIdx * 2 + 1];
-
-            // vec3::x attribute to be interpolated
-            __m128 sseAttrib0X = _mm_set_ps1(attrib0Vec3.x);
-            __m128 sseAttrib1X = _mm_set_ps1(attrib0Vec3.y);
-            __m128 sseAttrib2X = _mm_set_ps1(attrib0Vec3.z);
-
-            __m128 sseVec2AttribX = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0X, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1X, ssef1XY), sseAttrib2X));
-
-            // vec3::y attribute to be interpolated
-            __m128 sseAttrib0Y = _mm_set_ps1(attrib1Vec3.x);
-            __m128 sseAttrib1Y = _mm_set_ps1(attrib1Vec3.y);
-            __m128 sseAttrib2Y = _mm_set_ps1(attrib1Vec3.z);
-
-            __m128 sseVec2AttribY = _mm_add_ps(
-                _mm_mul_ps(sseAttrib0Y, ssef0XY),
-                _mm_add_ps(_mm_mul_ps(sseAttrib1Y, ssef1XY), sseAttrib2Y));
-
-            pInterpolatedAttributes[i].m_Vec2Attributes[i].m_SSEX = sseVec2AttribX;
-            pInterpolatedAttributes[i].m_Vec2Attributes[i].m_SSEY = sseVec2AttribY;
-        }
+        return c + glm::min(a * xMin, a * xMax) + glm::min(b * yMin, b * yMax);
     }
 }
\ No newline at end of file
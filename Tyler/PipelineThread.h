@@ -2,11 +2,14 @@
 
 #include "RasterizerConfig.h"
 #include "RenderState.h"
+#include "WaitEvent.h"
 
 namespace tyler
 {
     struct RenderEngine;
+    struct DrawIteration;
     struct CoverageMask;
+    struct CoverageMaskBuffer;
 
     // POD struct to pass SIMD registers initialized with EE coefficients to fragment-shader routines more easily
     struct SIMDEdgeCoefficients
@@ -22,26 +25,56 @@ namespace tyler
         __m128  m_SSEC4Edge0;
         __m128  m_SSEC4Edge1;
         __m128  m_SSEC4Edge2;
+
+        // Per-primitive step vectors to evaluate F0(x,y), F1(x,y) and F(x,y) = F0(x,y) + F1(x,y) + F2(x,y) incrementally
+
+        // F(x+s, y+t) - F(x, y) for sample centers (s, t) of a SIMD group, see g_scSampleGroupOffsets
+        __m128  m_SSEF0SampleOffsets;
+        __m128  m_SSEF1SampleOffsets;
+        __m128  m_SSEFSampleOffsets;
+
+        // F(x+w, y) - F(x, y) to step to the next SIMD group in a row
+        __m128  m_SSEF0ColumnStep;
+        __m128  m_SSEF1ColumnStep;
+        __m128  m_SSEFColumnStep;
+
+        // F(x, y+h) - F(x, y) to step to the next row of SIMD groups
+        __m128  m_SSEF0RowStep;
+        __m128  m_SSEF1RowStep;
+        __m128  m_SSEFRowStep;
+
+        // Coefficients of F(x,y) = F0(x,y) + F1(x,y) + F2(x,y)
+        __m128  m_SSEA4Sum;
+        __m128  m_SSEB4Sum;
+        __m128  m_SSEC4Sum;
+
+        // Coefficients of screen-space Z/W plane equation and its step vectors, so depth doesn't depend on f0(x,y) & f1(x,y)
+        __m128  m_SSEA4Depth;
+        __m128  m_SSEB4Depth;
+        __m128  m_SSEC4Depth;
+
+        __m128  m_SSEZSampleOffsets;
+        __m128  m_SSEZColumnStep;
+        __m128  m_SSEZRowStep;
     };
 
     // Thread execution state
     enum class ThreadStatus : uint8_t
     {
         IDLE,                               // Waiting for input arrival by RenderEngine
-        DRAWCALL_TOP,                       // Input data received, start processing drawcall
+        DRAWCALL_TOP,                       // Input data of a draw iteration received, start processing it
         DRAWCALL_GEOMETRY,                  // Geometry processing in progress
         DRAWCALL_BINNING,                   // Binning in progress
         DRAWCALL_SYNC_POINT_POST_BINNER,    // Sync post binning
         DRAWCALL_RASTERIZATION,             // Rasterization in progress
-        DRAWCALL_SYNC_POINT_POST_RASTER,    // Sync post rasterization
         DRAWCALL_FRAGMENTSHADER,            // Fragment processing in progress
-        DRAWCALL_BOTTOM,                    // Drawcall processed
+        TILE_RESOLVE,                       // Resolving tile buffers (or fast clears) to framebuffer
         TERMINATED                          // Thread shut down requested
     };
 
     struct PipelineThread
     {
-        PipelineThread(RenderEngine* pRenderEngine, uint32_t threadIdx);
+        PipelineThread(RenderEngine* pRenderEngine, uint32_t threadIdx, uint32_t processorIdx);
         ~PipelineThread();
 
         // Worker thread procedure
@@ -51,8 +84,26 @@ namespace tyler
         template<bool IsIndexed>
         void ProcessDrawcall();
 
+        // Resolve tiles fetched from RenderEngine until all tiles are resolved
+        void ExecuteTileResolve();
+
+        // Allocate the thread's own bins & coverage mask buffers of all tiles in the draw iteration, once per RT resolution
+        void AllocateTileStorage();
+
+        // Accumulate time elapsed since RenderEngine dispatched work that thread just woke up to
+        void RecordWakeUpLatency(const std::chrono::steady_clock::time_point& dispatchTime);
+
+        // Geometry processing (VS -> clipper -> triangle setup -> binner) of assigned primitives
+        // If IsDepthOnly, no attribute interpolation data is set up since FS won't be invoked
+        template<typename Shaders, bool IsIndexed, bool IsDepthOnly>
+        void ExecuteGeometry();
+
+        // Geometry processing of a contiguous range of primitives (all assigned ones, or a batch of them fetched dynamically)
+        template<typename Shaders, bool IsIndexed, bool IsDepthOnly>
+        void ExecuteGeometryBatch(uint32_t elemsStart, uint32_t elemsEnd);
+
         // Vertex Shader
-        template<bool IsIndexed>
+        template<typename Shaders, bool IsIndexed, bool IsDepthOnly>
         void ExecuteVertexShader(uint32_t drawIdx, uint32_t primIdx, glm::vec4* pV0Clip, glm::vec4* pV1Clip, glm::vec4* pV2Clip);
 
         // Clipper (full-triangle only)
@@ -67,52 +118,158 @@ namespace tyler
         // Rasterizer
         void ExecuteRasterizer();
 
+        // Set rows of the tile to be rasterized/fragment-shaded next, which is all of them unless the tile is split (see g_scTileSplittingEnabled)
+        void SetActiveSubTile(uint32_t tileIdx, uint32_t subTileIdx, uint32_t numSubTiles);
+
+        // Gather primitives binned for the tile by all threads to m_BinnedPrimitives in primitive order
+        void GatherBinnedPrimitives(uint32_t tileIdx);
+
+        // Rasterize a primitive binned for the tile at block/quad level within active sub-tile, emitting coverage masks to given buffer
+        // A single tile coverage mask is emitted if binned primitive index has g_scBinnedPrimTrivialAcceptFlag set
+        void RasterizePrimitive(uint32_t tileIdx, uint32_t primIdx, CoverageMaskBuffer* pCoverageMaskBuffer);
+
         // Fragment Shading
+        template<typename Pipeline>
         void ExecuteFragmentShader();
 
+        // Fragment-shade coverage masks of a buffer in order, setting up EE coefficients & step vectors whenever primitive changes
+        template<typename Pipeline>
+        void FragmentShadeCoverageMasks(
+            const CoverageMaskBuffer* pCoverageMaskBuffer,
+            SIMDEdgeCoefficients* pSIMDEERegs,
+            uint32_t* pCurrentPrimIdx);
+
+        // Set up SIMD registers of EE coefficients & step vectors of the primitive for fragment shading
+        template<typename Pipeline>
+        void SetupSIMDEdgeCoefficients(
+            uint32_t primIdx,
+            SIMDEdgeCoefficients* pSIMDEERegs);
+
         // Fragment shader routines at tile/block/fragment levels
+        template<typename Pipeline>
         void FragmentShadeTile(
             uint32_t tilePosX,
             uint32_t tilePosY,
             uint32_t primIdx,
             const SIMDEdgeCoefficients& simdEERegs);
 
+        template<typename Pipeline>
         void FragmentShadeBlock(
             uint32_t blockPosX,
             uint32_t blockPosY,
             uint32_t primIdx,
             const SIMDEdgeCoefficients& simdEERegs);
 
+        // Fragment-shade a block holding its lock if drawcall is order-independent
+        template<typename Pipeline>
+        void FragmentShadeBlockLocked(
+            uint32_t blockPosX,
+            uint32_t blockPosY,
+            uint32_t primIdx,
+            const SIMDEdgeCoefficients& simdEERegs);
+
+        template<typename Pipeline>
         void FragmentShadeQuad(
             CoverageMask* pMask,
             const SIMDEdgeCoefficients& simdEERegs);
 
+        // Fragment-shade a fully covered block with a single block FS invocation
+        template<typename Pipeline>
+        void FragmentShadeBlockSoA(
+            uint32_t blockPosX,
+            uint32_t blockPosY,
+            uint32_t primIdx,
+            const SIMDEdgeCoefficients& simdEERegs);
+
+        // Append live fragments of a SIMD group to the packed SIMD group, invoking FS whenever it's full
+        template<typename Pipeline>
+        void PackFragments(
+            int liveMask,
+            uint32_t sampleX,
+            uint32_t sampleY,
+            const InterpolatedAttributes& interpolatedAttributes);
+
+        // Invoke FS for fragments packed so far, if any, and write their colors
+        template<typename Pipeline>
+        void FlushPackedFragments();
+
+        // FS output of a primitive whose FS output is constant (see g_scShaderHintConstantOutput), broadcast to 4 samples as R8G8B8A8_UNORM
+        // FS is only invoked (at the SIMD group starting at given sample) when primitive changes
+        template<typename Pipeline>
+        __m128i FetchConstantFragmentOutput(
+            uint32_t primIdx,
+            uint32_t sampleX,
+            uint32_t sampleY,
+            const SIMDEdgeCoefficients& simdEERegs);
+
+        // Fetch subpass inputs of the SIMD group starting at given sample
+        void FetchSubpassInput(
+            uint32_t sampleX,
+            uint32_t sampleY,
+            InterpolatedAttributes* pInterpolatedAttributes);
+
+        // Scatter interpolated attributes of a SIMD group to block FS input
+        template<typename Pipeline>
+        void StoreBlockInterpolatedAttributes(
+            uint32_t sampleGroupIdx,
+            const InterpolatedAttributes& interpolatedAttributes);
+
+        // Gather block FS output of a SIMD group
+        void LoadBlockFragmentOutput(
+            uint32_t sampleGroupIdx,
+            FragmentOutput* pFragmentOutput) const;
+
         // Given three clip-space verices, compute the bounding box of a triangle clamped to width/height
         Rect2D ComputeBoundingBox(const glm::vec4& v0Clip, const glm::vec4& v1Clip, const glm::vec4& v2Clip, float width, float height) const;
 
         // Calculate interpolation coefficients to be used during FS
         // to calculate perspective-correct interpolation of vertex attributes
+        template<typename Shaders>
         void CalculateInterpolationCoefficients(
             uint32_t drawIDx,
             const VertexAttributes& vertexAttribs0,
             const VertexAttributes& vertexAttribs1,
             const VertexAttributes& vertexAttribs2);
 
-        // Compute interpolation basis functions f0(x,y) & f1(x,y)
-        void ComputeParameterBasisFunctions(
+        // Evaluate F0(x,y), F1(x,y) & F(x,y) for the SIMD group starting at given sample, to be stepped incrementally afterwards
+        void ComputeEdgeFunctionsAtSample(
             uint32_t sampleX,
             uint32_t sampleY,
             const SIMDEdgeCoefficients& simdEERegs,
+            __m128* pSSEF0XY,
+            __m128* pSSEF1XY,
+            __m128* pSSEFXY);
+
+        // Compute interpolation basis functions f0(x,y) & f1(x,y) from evaluated F0(x,y), F1(x,y) & F(x,y)
+        void ComputeParameterBasisFunctions(
+            const __m128& sseF0XY,
+            const __m128& sseF1XY,
+            const __m128& sseFXY,
             __m128* pSSEf0XY,
             __m128* pSSEf1XY);
 
-        // Using basis functions, interpolated Z values (for depth test)
-        __m128 InterpolateDepthValues(
-            uint32_t primIdx,
-            const __m128& ssef0XY,
-            const __m128& ssef1XY);
+        // Depth test of Z values at the SIMD group starting at given sample, returning pass mask and resulting depth values
+        template<typename Pipeline>
+        __m128 PerformDepthTest(
+            const __m128& sseZInterpolated,
+            uint32_t sampleX,
+            uint32_t sampleY,
+            __m128* pSSEDepthResolved);
+
+        // Evaluate Z/W plane equation for the SIMD group starting at given sample (for depth test)
+        __m128 ComputeDepthValuesAtSample(
+            uint32_t sampleX,
+            uint32_t sampleY,
+            const SIMDEdgeCoefficients& simdEERegs);
+
+        // Min Z/W value of the primitive within 8x8 block, given that block is fully covered
+        float ComputeMinDepthValueInBlock(
+            uint32_t blockPosX,
+            uint32_t blockPosY,
+            const SIMDEdgeCoefficients& simdEERegs);
 
         // Using basis functions computed already, interpolate each attribute channel present
+        template<typename Pipeline>
         void InterpolateVertexAttributes(
             uint32_t primIdx,
             const __m128& ssef0XY,
@@ -122,6 +279,7 @@ namespace tyler
         // Utilities for VS$
         bool PerformVertexCacheLookup(uint32_t primIdx, uint32_t* pCachedIdx);
         void CacheVertexData(uint32_t vertexIdx, const glm::vec4& vClip, const tyler::VertexAttributes& tempVertexAttrib);
+        template<typename Shaders>
         void CopyVertexData(uint32_t cacheEntry, glm::vec4* pVClip, VertexAttributes* pTempVertexAttrib);
 
         // Unique RenderEngine instance
@@ -131,12 +289,29 @@ namespace tyler
         // Unique thread index among all PipelineThreads created
         uint32_t                    m_ThreadIdx;
 
+        // Logical processor the worker thread is pinned to, see RasterizerConfig::m_ThreadAffinity
+        uint32_t                    m_ProcessorIdx;
+
         // Underlying thread that will be used to execute all stages of the pipeline in order
         std::thread                 m_WorkerThread;
 
         // Thread execution state
         std::atomic<ThreadStatus>   m_CurrentState;
 
+        // Signaled by RenderEngine when there's work for thread or it's to be terminated
+        WaitEvent                   m_WakeUpEvent;
+
+        // # draw iterations processed so far, thread has work to do as long as it's behind RenderEngine::m_NumDispatchedIterations
+        std::atomic<uint32_t>       m_NumCompletedIterations;
+
+        // Draw iteration being processed
+        DrawIteration*              m_pDrawIteration = nullptr;
+
+        // Wake-up latency stats in nanoseconds, see g_scWakeUpStatsEnabled
+        uint64_t                    m_NumWakeUps = 0u;
+        uint64_t                    m_TotalWakeUpLatency = 0u;
+        uint64_t                    m_MaxWakeUpLatency = 0u;
+
         // VS$ entry
         struct VertexCache
         {
@@ -150,13 +325,38 @@ namespace tyler
         // Intermediate vertex attributes used for VS invocations
         VertexAttributes            m_TempVertexAttributes[3];
 
+        // Block FS input/output, too large to live on the stack
+        BlockInterpolatedAttributes m_BlockInterpolatedAttributes;
+        BlockFragmentOutput         m_BlockFragmentOutput;
+
+        // Indices of primitives binned for the tile being rasterized in primitive order, and read positions of per-thread bins to merge them
+        std::vector<uint32_t>       m_BinnedPrimitives;
+        std::vector<uint32_t>       m_BinCursors;
+
+        // Framebuffer rows [m_SubTileMinY, m_SubTileMaxY) of the tile being rasterized/fragment-shaded, coverage masks outside of them are ignored
+        uint32_t                    m_SubTileMinY = 0u;
+        uint32_t                    m_SubTileMaxY = 0u;
+
+        // Coverage masks of a single primitive binned for the tile being rasterized & fragment-shaded (if g_scFusedRasterShadeEnabled or drawcall is order-independent)
+        CoverageMaskBuffer*         m_pTileCoverageMasks = nullptr;
+
+        // Live fragments of partially covered quads (possibly of different primitives) waiting to be fragment-shaded together
+        InterpolatedAttributes      m_PackedAttributes;
+        uint32_t                    m_PackedSampleX[g_scSIMDWidth];
+        uint32_t                    m_PackedSampleY[g_scSIMDWidth];
+        uint32_t                    m_NumPackedFragments = 0u;
+
+        // Cached FS output of the last primitive with constant FS output
+        __m128i                     m_SSEConstantFragmentOutput;
+        uint32_t                    m_ConstantFragmentOutputPrimIdx = UINT32_MAX;
+
         // Array of indices of cached vertices
         uint32_t                    m_CachedVertexIndices[g_scVertexShaderCacheSize];
         // Number of vertices currently cached
         uint32_t                    m_NumVertexCacheEntries;
 
-        // Per-drawcall data, to be prepared by RenderEngine
-        // before a drawcall arrival will be issued to a thread
+        // Per-draw iteration data, to be prepared by RenderEngine
+        // before a draw iteration will be issued to a thread
         struct DrawParams
         {
             // Start and end indices into the drawcall data (vertex/index buffer)
@@ -168,5 +368,8 @@ namespace tyler
             // Drawcall is indexed or not
             bool                    m_IsIndexed = false;
         }                           m_ActiveDrawParams;
+
+        // Draw params of draw iterations in flight, draw iteration N uses m_DrawParams[N % g_scMaxDrawIterationsInFlight]
+        DrawParams                  m_DrawParams[g_scMaxDrawIterationsInFlight];
     };
 }
\ No newline at end of file
@@ -0,0 +1,1311 @@
+#pragma once
+
+#include "PipelineThread.h"
+#include "RenderEngine.h"
+#include "RenderState.h"
+
+// Shader-dependent stages of PipelineThread. They're templated on shader traits (see ShaderPipeline.h) and instantiated per pipeline,
+// so that typed pipelines get shader bodies inlined and attribute loops unrolled to their compile-time counts
+namespace tyler
+{
+    template<typename Shaders, bool IsIndexed, bool IsDepthOnly>
+    void PipelineThread::ExecuteGeometry()
+    {
+        if constexpr (g_scDynamicGeometryDistributionEnabled)
+        {
+            // Assigned range is the whole draw iteration, keep fetching batches of it until all are processed by some thread
+            // Batches are fetched in order, so each per-thread bin of a tile is still sorted by primitive index
+            const uint32_t numPrims = m_ActiveDrawParams.m_ElemsEnd - m_ActiveDrawParams.m_ElemsStart;
+
+            uint32_t batchOffset;
+            while ((batchOffset = m_pDrawIteration->m_NextGeometryBatchOffset.fetch_add(g_scGeometryBatchSize, std::memory_order_relaxed)) < numPrims)
+            {
+                const uint32_t batchStart = m_ActiveDrawParams.m_ElemsStart + batchOffset;
+                const uint32_t batchEnd = m_ActiveDrawParams.m_ElemsStart + glm::min(batchOffset + g_scGeometryBatchSize, numPrims);
+
+                ExecuteGeometryBatch<Shaders, IsIndexed, IsDepthOnly>(batchStart, batchEnd);
+            }
+        }
+        else
+        {
+            ExecuteGeometryBatch<Shaders, IsIndexed, IsDepthOnly>(m_ActiveDrawParams.m_ElemsStart, m_ActiveDrawParams.m_ElemsEnd);
+        }
+    }
+
+    template<typename Shaders, bool IsIndexed, bool IsDepthOnly>
+    void PipelineThread::ExecuteGeometryBatch(uint32_t elemsStart, uint32_t elemsEnd)
+    {
+        // Iterate over triangles in given drawcall range
+        for (uint32_t drawIdx = elemsStart, primIdx = elemsStart % m_RenderConfig.m_MaxDrawIterationSize;
+            drawIdx < elemsEnd;
+            drawIdx++, primIdx++)
+        {
+            // drawIdx = Assigned prim indices which will be only used to fetch indices
+            // primIdx = Prim index relative to current iteration
+
+            // Clip-space vertices to be retrieved from VS
+            glm::vec4 v0Clip, v1Clip, v2Clip;
+
+            // VS
+            ExecuteVertexShader<Shaders, IsIndexed, IsDepthOnly>(drawIdx, primIdx, &v0Clip, &v1Clip, &v2Clip);
+
+            // Bbox of the primitive which will be computed during clipping
+            Rect2D bbox;
+
+            // CLIPPER
+            if (!ExecuteFullTriangleClipping(primIdx, v0Clip, v1Clip, v2Clip, &bbox))
+            {
+                // Triangle clipped, proceed iteration with next primitive
+                continue;
+            }
+
+            // TRIANGLE SETUP & CULL
+            if (!ExecuteTriangleSetupAndCull(primIdx, v0Clip, v1Clip, v2Clip))
+            {
+                // Triangle culled, proceed iteration with next primitive
+                continue;
+            }
+
+            // BINNER
+            ExecuteBinner(primIdx, bbox);
+        }
+    }
+
+    template<typename Shaders, bool IsIndexed, bool IsDepthOnly>
+    void PipelineThread::ExecuteVertexShader(uint32_t drawIdx, uint32_t primIdx, glm::vec4* pV0Clip, glm::vec4* pV1Clip, glm::vec4* pV2Clip)
+    {
+        uint8_t* pVertexBuffer = static_cast<uint8_t*>(m_pRenderEngine->m_pVertexBuffer);
+        IndexBuffer* pIndexBuffer = m_pRenderEngine->m_pIndexBuffer;
+        ASSERT((pVertexBuffer != nullptr) && (!IsIndexed || (pIndexBuffer != nullptr)));
+
+        ConstantBuffer* pConstantBuffer = m_pRenderEngine->m_pConstantBuffer;
+
+        uint32_t vertexStride = m_pRenderEngine->m_VertexInputStride;
+        uint32_t vertexOffset = m_ActiveDrawParams.m_VertexOffset;
+
+        VertexAttributes* pTempVertexAttrib0 = &m_TempVertexAttributes[0];
+        VertexAttributes* pTempVertexAttrib1 = &m_TempVertexAttributes[1];
+        VertexAttributes* pTempVertexAttrib2 = &m_TempVertexAttributes[2];
+
+        auto VS = Shaders::GetVertexShader(m_pRenderEngine);
+
+        if constexpr (g_scVertexShaderCacheEnabled && IsIndexed)
+        {
+            uint32_t cacheEntry0 = UINT32_MAX;
+            uint32_t cacheEntry1 = UINT32_MAX;
+            uint32_t cacheEntry2 = UINT32_MAX;
+
+            uint32_t vertexIdx0 = pIndexBuffer[vertexOffset + (3 * drawIdx + 0)];
+            uint32_t vertexIdx1 = pIndexBuffer[vertexOffset + (3 * drawIdx + 1)];
+            uint32_t vertexIdx2 = pIndexBuffer[vertexOffset + (3 * drawIdx + 2)];
+
+            if (PerformVertexCacheLookup(vertexIdx0, &cacheEntry0))
+            {
+                // Vertex 0 is found in the cache, skip VS and fetch cached data
+                CopyVertexData<Shaders>(cacheEntry0, pV0Clip, pTempVertexAttrib0);
+            }
+            else
+            {
+                // Vertex 0 is not found in the cache,
+                // first invoke VS and then cache the clip-space position & vertex attributes
+
+                uint8_t* pVertIn0 = &pVertexBuffer[vertexStride * vertexIdx0];
+                *pV0Clip = VS(pVertIn0, pTempVertexAttrib0, pConstantBuffer);
+
+                CacheVertexData(vertexIdx0, *pV0Clip, *pTempVertexAttrib0);
+            }
+
+            if (PerformVertexCacheLookup(vertexIdx1, &cacheEntry1))
+            {
+                // Vertex 1 is found in the cache, skip VS and fetch cached data
+                CopyVertexData<Shaders>(cacheEntry1, pV1Clip, pTempVertexAttrib1);
+            }
+            else
+            {
+                // Vertex 1 is not found in the cache,
+                // first invoke VS and then cache the clip-space position & vertex attributes
+
+                uint8_t* pVertIn1 = &pVertexBuffer[vertexStride * vertexIdx1];
+                *pV1Clip = VS(pVertIn1, pTempVertexAttrib1, pConstantBuffer);
+
+                CacheVertexData(vertexIdx1, *pV1Clip, *pTempVertexAttrib1);
+            }
+
+            if (PerformVertexCacheLookup(vertexIdx2, &cacheEntry2))
+            {
+                // Vertex 2 is found in the cache, skip VS and fetch cached data
+                CopyVertexData<Shaders>(cacheEntry2, pV2Clip, pTempVertexAttrib2);
+            }
+            else
+            {
+                // Vertex 2 is not found in the cache,
+                // first invoke VS and then cache the clip-space position & vertex attributes
+
+                uint8_t* pVertIn2 = &pVertexBuffer[vertexStride * vertexIdx2];
+                *pV2Clip = VS(pVertIn2, pTempVertexAttrib2, pConstantBuffer);
+
+                CacheVertexData(vertexIdx2, *pV2Clip, *pTempVertexAttrib2);
+            }
+        }
+        else if (IsIndexed)
+        {
+            // VS$ disabled, don't look up vertices in the cache
+
+            // Fetch pointers to vertex input that'll be passed to vertex shader
+            uint8_t* pVertIn0 = &pVertexBuffer[vertexStride * pIndexBuffer[vertexOffset + (3 * drawIdx + 0)]];
+            uint8_t* pVertIn1 = &pVertexBuffer[vertexStride * pIndexBuffer[vertexOffset + (3 * drawIdx + 1)]];
+            uint8_t* pVertIn2 = &pVertexBuffer[vertexStride * pIndexBuffer[vertexOffset + (3 * drawIdx + 2)]];
+
+            // Invoke vertex shader with vertex attributes payload
+            *pV0Clip = VS(pVertIn0, pTempVertexAttrib0, pConstantBuffer);
+            *pV1Clip = VS(pVertIn1, pTempVertexAttrib1, pConstantBuffer);
+            *pV2Clip = VS(pVertIn2, pTempVertexAttrib2, pConstantBuffer);
+        }
+        else
+        {
+            // Fetch pointers to vertex input that'll be passed to vertex shader
+            uint8_t* pVertIn0 = &pVertexBuffer[vertexOffset + vertexStride * (3 * drawIdx + 0)];
+            uint8_t* pVertIn1 = &pVertexBuffer[vertexOffset + vertexStride * (3 * drawIdx + 1)];
+            uint8_t* pVertIn2 = &pVertexBuffer[vertexOffset + vertexStride * (3 * drawIdx + 2)];
+
+            // Invoke vertex shader with vertex attributes payload
+            *pV0Clip = VS(pVertIn0, pTempVertexAttrib0, pConstantBuffer);
+            *pV1Clip = VS(pVertIn1, pTempVertexAttrib1, pConstantBuffer);
+            *pV2Clip = VS(pVertIn2, pTempVertexAttrib2, pConstantBuffer);
+        }
+
+        if constexpr (!IsDepthOnly)
+        {
+            // Calculate interpolation data for active vertex attributes
+            CalculateInterpolationCoefficients<Shaders>(primIdx, *pTempVertexAttrib0, *pTempVertexAttrib1, *pTempVertexAttrib2);
+        }
+    }
+
+    template<typename Shaders>
+    void PipelineThread::CopyVertexData(uint32_t cacheEntry, glm::vec4* pVClip, VertexAttributes* pTempVertexAttrib)
+    {
+        ASSERT((pVClip != nullptr) && (pTempVertexAttrib != nullptr));
+
+        // Copy cached clip-space positions
+        *pVClip = m_VertexCacheEntries[cacheEntry].m_ClipPos;
+
+        // Copy vertex (only active!) attributes
+        memcpy(
+            pTempVertexAttrib->m_Attributes2,
+            m_VertexCacheEntries[cacheEntry].m_VertexAttribs.m_Attributes2,
+            sizeof(glm::vec2) * Shaders::NumVec2Attributes(m_pRenderEngine));
+
+        memcpy(
+            pTempVertexAttrib->m_Attributes3,
+            m_VertexCacheEntries[cacheEntry].m_VertexAttribs.m_Attributes3,
+            sizeof(glm::vec3) * Shaders::NumVec3Attributes(m_pRenderEngine));
+
+        memcpy(
+            pTempVertexAttrib->m_Attributes4,
+            m_VertexCacheEntries[cacheEntry].m_VertexAttribs.m_Attributes4,
+            sizeof(glm::vec4) * Shaders::NumVec4Attributes(m_pRenderEngine));
+    }
+
+    template<typename Shaders>
+    void PipelineThread::CalculateInterpolationCoefficients(
+        uint32_t drawIDx,
+        const VertexAttributes& vertexAttribs0,
+        const VertexAttributes& vertexAttribs1,
+        const VertexAttributes& vertexAttribs2)
+    {
+        // f0 + f1 + f2 = 1
+        // f0 * x0 + f1 * x1 + f2 * x2 ==> f0 * (x0 - x2) + f1 * (x1 - x2) + x2
+
+        // vec4 attributes
+        for (uint32_t i = 0; i < Shaders::NumVec4Attributes(m_pRenderEngine); i++)
+        {
+            const glm::vec4& attrib0 = vertexAttribs0.m_Attributes4[i];
+            const glm::vec4& attrib1 = vertexAttribs1.m_Attributes4[i];
+            const glm::vec4& attrib2 = vertexAttribs2.m_Attributes4[i];
+
+            // Store computed deltas in setup buffers for vec4 xyzw attributes
+            m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 0] = glm::vec3((attrib0.x - attrib2.x), (attrib1.x - attrib2.x), attrib2.x);
+            m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 1] = glm::vec3((attrib0.y - attrib2.y), (attrib1.y - attrib2.y), attrib2.y);
+            m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 2] = glm::vec3((attrib0.z - attrib2.z), (attrib1.z - attrib2.z), attrib2.z);
+            m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][drawIDx * 4 + 3] = glm::vec3((attrib0.w - attrib2.w), (attrib1.w - attrib2.w), attrib2.w);
+        }
+
+        // vec3 attributes
+        for (uint32_t i = 0; i < Shaders::NumVec3Attributes(m_pRenderEngine); i++)
+        {
+            const glm::vec3& attrib0 = vertexAttribs0.m_Attributes3[i];
+            const glm::vec3& attrib1 = vertexAttribs1.m_Attributes3[i];
+            const glm::vec3& attrib2 = vertexAttribs2.m_Attributes3[i];
+
+            // Store computed deltas in setup buffers for vec3 xyz attributes
+            m_pDrawIteration->m_SetupBuffers.m_Attribute3Deltas[i][drawIDx * 3 + 0] = glm::vec3((attrib0.x - attrib2.x), (attrib1.x - attrib2.x), attrib2.x);
+            m_pDrawIteration->m_SetupBuffers.m_Attribute3Deltas[i][drawIDx * 3 + 1] = glm::vec3((attrib0.y - attrib2.y), (attrib1.y - attrib2.y), attrib2.y);
+            m_pDrawIteration->m_SetupBuffers.m_Attribute3Deltas[i][drawIDx * 3 + 2] = glm::vec3((attrib0.z - attrib2.z), (attrib1.z - attrib2.z), attrib2.z);
+        }
+
+        // vec2 attributes
+        for (uint32_t i = 0; i < Shaders::NumVec2Attributes(m_pRenderEngine); i++)
+        {
+            const glm::vec2& attrib0 = vertexAttribs0.m_Attributes2[i];
+            const glm::vec2& attrib1 = vertexAttribs1.m_Attributes2[i];
+            const glm::vec2& attrib2 = vertexAttribs2.m_Attributes2[i];
+
+            // Store computed deltas in setup buffers for vec2 xy attributes
+            m_pDrawIteration->m_SetupBuffers.m_Attribute2Deltas[i][drawIDx * 2 + 0] = glm::vec3((attrib0.x - attrib2.x), (attrib1.x - attrib2.x), attrib2.x);
+            m_pDrawIteration->m_SetupBuffers.m_Attribute2Deltas[i][drawIDx * 2 + 1] = glm::vec3((attrib0.y - attrib2.y), (attrib1.y - attrib2.y), attrib2.y);
+        }
+    }
+
+    template<typename Pipeline>
+    __m128 PipelineThread::PerformDepthTest(const __m128& sseZInterpolated, uint32_t sampleX, uint32_t sampleY, __m128* pSSEDepthResolved)
+    {
+        ASSERT(pSSEDepthResolved != nullptr);
+
+        if constexpr (Pipeline::s_DepthFunc == DepthFunc::NEVER)
+        {
+            *pSSEDepthResolved = m_pRenderEngine->FetchDepthBuffer(sampleX, sampleY);
+            return _mm_setzero_ps();
+        }
+        else if constexpr (Pipeline::s_DepthFunc == DepthFunc::ALWAYS)
+        {
+            // No need to read depth buffer at all
+            *pSSEDepthResolved = sseZInterpolated;
+            return _mm_castsi128_ps(_mm_set1_epi32(-1));
+        }
+        else
+        {
+            // Load current depth buffer contents
+            __m128 sseDepthCurrent = m_pRenderEngine->FetchDepthBuffer(sampleX, sampleY);
+
+            __m128 sseDepthRes;
+            switch (Pipeline::s_DepthFunc)
+            {
+            case DepthFunc::LESS:           sseDepthRes = _mm_cmplt_ps(sseZInterpolated, sseDepthCurrent); break;
+            case DepthFunc::EQUAL:          sseDepthRes = _mm_cmpeq_ps(sseZInterpolated, sseDepthCurrent); break;
+            case DepthFunc::LESS_EQUAL:     sseDepthRes = _mm_cmple_ps(sseZInterpolated, sseDepthCurrent); break;
+            case DepthFunc::GREATER:        sseDepthRes = _mm_cmpgt_ps(sseZInterpolated, sseDepthCurrent); break;
+            case DepthFunc::NOT_EQUAL:      sseDepthRes = _mm_cmpneq_ps(sseZInterpolated, sseDepthCurrent); break;
+            case DepthFunc::GREATER_EQUAL:  sseDepthRes = _mm_cmpge_ps(sseZInterpolated, sseDepthCurrent); break;
+            default:                        sseDepthRes = _mm_setzero_ps(); ASSERT(false); break;
+            }
+
+            // Depth buffer contents after the test, if depth writes are enabled
+            *pSSEDepthResolved = _mm_blendv_ps(sseDepthCurrent, sseZInterpolated, sseDepthRes);
+
+            return sseDepthRes;
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::ExecuteFragmentShader()
+    {
+        if constexpr (Pipeline::s_IsNoOp)
+        {
+            // Bound state doesn't write anything, so there's nothing to fragment-shade
+            if constexpr (g_scMaxDrawIterationsInFlight > 1)
+            {
+                // Tiles must still be marked as fragment-shaded in order, so that they can be fragment-shaded in next draw iterations
+                uint32_t nextQueueEntry;
+                while ((nextQueueEntry = g_scFusedRasterShadeEnabled ? m_pRenderEngine->FetchNextTileForRasterization(m_pDrawIteration) : m_pRenderEngine->FetchNextTileForFragmentShading(m_pDrawIteration)) != g_scInvalidTileIndex)
+                {
+                    const uint32_t nextTileIdx = RenderEngine::GetQueuedTileIndex(nextQueueEntry);
+
+                    m_pRenderEngine->WaitForTileToCompleteShadingOfPreviousIterations(m_pDrawIteration, nextTileIdx);
+                    m_pRenderEngine->SignalTileShadingComplete(m_pDrawIteration, nextTileIdx);
+                }
+            }
+
+            return;
+        }
+
+        // SIMD registers of EE coefficients & step vectors of the primitive that is currently being fragment-shaded
+        SIMDEdgeCoefficients simdEERegs;
+        uint32_t currentPrimIdx = UINT32_MAX;
+
+        // Primitive indices are relative to draw iteration, so FS output cached in previous iteration is stale
+        m_ConstantFragmentOutputPrimIdx = UINT32_MAX;
+
+        // Queue entries of order-independent drawcalls are per-thread bins of tiles, each rasterized & fragment-shaded a primitive at a time
+        // while other bins of the same tile may be processed by other threads concurrently
+        const bool isOrderIndependent = m_pRenderEngine->m_IsOrderIndependent;
+
+        uint32_t nextQueueEntry;
+        while ((nextQueueEntry = g_scFusedRasterShadeEnabled ? m_pRenderEngine->FetchNextTileForRasterization(m_pDrawIteration) : m_pRenderEngine->FetchNextTileForFragmentShading(m_pDrawIteration)) != g_scInvalidTileIndex)
+        {
+            const uint32_t nextTileIdx = RenderEngine::GetQueuedTileIndex(nextQueueEntry);
+            ASSERT(nextTileIdx < (m_pRenderEngine->m_NumTilePerRow * m_pRenderEngine->m_NumTilePerColumn));
+
+            const uint32_t workItemIdx = RenderEngine::GetQueuedWorkItemIndex(nextQueueEntry);
+
+            // Only rows of the sub-tile are fragment-shaded if the tile is split, other sub-tiles may be fragment-shaded by other threads concurrently
+            if (isOrderIndependent)
+            {
+                SetActiveSubTile(nextTileIdx, 0u, 1u);
+            }
+            else
+            {
+                SetActiveSubTile(nextTileIdx, workItemIdx, m_pDrawIteration->m_TileStates[nextTileIdx].m_NumWorkItems);
+            }
+
+            if (!g_scFusedRasterShadeEnabled && !isOrderIndependent)
+            {
+                // Tile may still be rasterized by another thread
+                m_pRenderEngine->WaitForTileToCompleteRasterization(m_pDrawIteration, nextTileIdx);
+            }
+
+            if constexpr (g_scMaxDrawIterationsInFlight > 1)
+            {
+                // Tile may still be fragment-shaded in previous draw iteration by another thread
+                m_pRenderEngine->WaitForTileToCompleteShadingOfPreviousIterations(m_pDrawIteration, nextTileIdx);
+            }
+
+            if constexpr (g_scTileBuffersEnabled)
+            {
+                // Tile (or its work item) is owned by this thread now, bring its contents in if this is the first time it's touched in render pass
+                m_pRenderEngine->LoadTileBuffersForFragmentShading(m_pDrawIteration, nextTileIdx);
+            }
+
+            if (isOrderIndependent)
+            {
+                // TA coverage masks emitted by the binner thread, then the rest of primitives binned by it
+                if constexpr (g_scBinnerEmitsTrivialAcceptMasks)
+                {
+                    const CoverageMaskBuffer* pCoverageMasks = m_pDrawIteration->m_CoverageMasks[nextTileIdx][workItemIdx];
+                    if (pCoverageMasks->GetNumCoverageMasks() > 0u)
+                    {
+                        FragmentShadeCoverageMasks<Pipeline>(pCoverageMasks, &simdEERegs, &currentPrimIdx);
+                    }
+                }
+
+                for (uint32_t binnedPrimIdx : m_pDrawIteration->m_BinList[nextTileIdx][workItemIdx])
+                {
+                    m_pTileCoverageMasks->ResetAllocationList();
+
+                    RasterizePrimitive(nextTileIdx, binnedPrimIdx, m_pTileCoverageMasks);
+
+                    FragmentShadeCoverageMasks<Pipeline>(m_pTileCoverageMasks, &simdEERegs, &currentPrimIdx);
+                }
+            }
+            else if constexpr (g_scFusedRasterShadeEnabled)
+            {
+                // Go through all primitives binned for the tile in-order, rasterizing and fragment-shading one primitive at a time
+                GatherBinnedPrimitives(nextTileIdx);
+
+                for (uint32_t binnedPrimIdx : m_BinnedPrimitives)
+                {
+                    // Coverage masks of the previous primitive are consumed already
+                    m_pTileCoverageMasks->ResetAllocationList();
+
+                    RasterizePrimitive(nextTileIdx, binnedPrimIdx, m_pTileCoverageMasks);
+
+                    FragmentShadeCoverageMasks<Pipeline>(m_pTileCoverageMasks, &simdEERegs, &currentPrimIdx);
+                }
+            }
+            else
+            {
+                // Fragment-shade visible samples consuming coverage masks emitted previously by the rasterizer stage
+
+                // Get per-thread coverage mask and process them in order
+                for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
+                {
+                    FragmentShadeCoverageMasks<Pipeline>(m_pDrawIteration->m_CoverageMasks[nextTileIdx][i], &simdEERegs, &currentPrimIdx);
+                }
+            }
+
+            // Tile is done, so are all of its fragments
+            FlushPackedFragments<Pipeline>();
+
+            if constexpr (g_scMaxDrawIterationsInFlight > 1)
+            {
+                // Tile can be fragment-shaded in next draw iteration now
+                m_pRenderEngine->SignalTileShadingComplete(m_pDrawIteration, nextTileIdx);
+            }
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FragmentShadeCoverageMasks(const CoverageMaskBuffer* pCoverageMaskBuffer, SIMDEdgeCoefficients* pSIMDEERegs, uint32_t* pCurrentPrimIdx)
+    {
+        ASSERT(pCoverageMaskBuffer != nullptr);
+        ASSERT(pCoverageMaskBuffer->m_NumAllocations > 0);
+
+        for (uint32_t numAlloc = 0; numAlloc < pCoverageMaskBuffer->m_NumAllocations; numAlloc++)
+        {
+            const auto& currentSlot = pCoverageMaskBuffer->m_AllocationList[numAlloc];
+
+            for (uint32_t numMask = 0; numMask < currentSlot.m_AllocationCount; numMask++)
+            {
+                ASSERT(currentSlot.m_pData != nullptr);
+
+                CoverageMask* pMask = &currentSlot.m_pData[numMask];
+
+                if ((pMask->m_Type != CoverageMaskType::TILE) && ((pMask->m_SampleY < m_SubTileMinY) || (pMask->m_SampleY >= m_SubTileMaxY)))
+                {
+                    // Block/quad is in another sub-tile of the tile
+                    continue;
+                }
+
+                // In many cases, next N coverage masks will have been generated for the same primitive
+                // that we're fragment-shading at tile, block or fragment levels here,
+                // so EE coefficients and step vectors are only set up again when primitive changes
+                if (pMask->m_PrimIdx != *pCurrentPrimIdx)
+                {
+                    *pCurrentPrimIdx = pMask->m_PrimIdx;
+                    SetupSIMDEdgeCoefficients<Pipeline>(*pCurrentPrimIdx, pSIMDEERegs);
+                }
+
+                switch (pMask->m_Type)
+                {
+                case CoverageMaskType::TILE:
+                    LOG("Thread %d fragment-shading tile (%d, %d)\n", m_ThreadIdx, pMask->m_SampleX, pMask->m_SampleY);
+                    // Color writes of packed fragments must precede those of subsequent primitives
+                    FlushPackedFragments<Pipeline>();
+                    FragmentShadeTile<Pipeline>(pMask->m_SampleX, pMask->m_SampleY, pMask->m_PrimIdx, *pSIMDEERegs);
+                    break;
+                case CoverageMaskType::BLOCK:
+                    LOG("Thread %d fragment-shading blocks\n", m_ThreadIdx);
+                    FlushPackedFragments<Pipeline>();
+                    FragmentShadeBlockLocked<Pipeline>(pMask->m_SampleX, pMask->m_SampleY, pMask->m_PrimIdx, *pSIMDEERegs);
+                    break;
+                case CoverageMaskType::QUAD:
+                    LOG("Thread %d fragment-shading coverage masks\n", m_ThreadIdx);
+                    if (m_pRenderEngine->m_IsOrderIndependent)
+                    {
+                        m_pRenderEngine->LockBlock(pMask->m_SampleX, pMask->m_SampleY);
+                        FragmentShadeQuad<Pipeline>(pMask, *pSIMDEERegs);
+                        m_pRenderEngine->UnlockBlock(pMask->m_SampleX, pMask->m_SampleY);
+                    }
+                    else
+                    {
+                        FragmentShadeQuad<Pipeline>(pMask, *pSIMDEERegs);
+                    }
+                    break;
+                default:
+                    ASSERT(false);
+                    break;
+                }
+            }
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::SetupSIMDEdgeCoefficients(uint32_t primIdx, SIMDEdgeCoefficients* pSIMDEERegs)
+    {
+        // Offsets of sample centers within a SIMD group
+        const __m128 sseSampleOffsetsX4 = _mm_add_ps(_mm_loadu_ps(g_scSampleGroupOffsets.m_X), _mm_set_ps1(0.5f));
+        const __m128 sseSampleOffsetsY4 = _mm_add_ps(_mm_loadu_ps(g_scSampleGroupOffsets.m_Y), _mm_set_ps1(0.5f));
+
+        // Steps to next SIMD group in a row & to next row of SIMD groups
+        const __m128 sseColumnStep = _mm_set_ps1(static_cast<float>(g_scSampleGroupWidth));
+        const __m128 sseRowStep = _mm_set_ps1(static_cast<float>(g_scSampleGroupHeight));
+
+        // Depth-only variants test coverage during rasterization and depth via Z/W plane equation alone, so they never need EE coefficients
+        if constexpr (Pipeline::s_FragmentShaderEnabled)
+        {
+            // First fetch EE coefficients that will be used (in addition to edge in/out tests) for perspective-correct interpolation of vertex attributes
+            const glm::vec3 ee0 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 0];
+            const glm::vec3 ee1 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 1];
+            const glm::vec3 ee2 = m_pDrawIteration->m_SetupBuffers.m_pEdgeCoefficients[3 * primIdx + 2];
+
+            // Store edge 0 coefficients
+            pSIMDEERegs->m_SSEA4Edge0 = _mm_set_ps1(ee0.x);
+            pSIMDEERegs->m_SSEB4Edge0 = _mm_set_ps1(ee0.y);
+            pSIMDEERegs->m_SSEC4Edge0 = _mm_set_ps1(ee0.z);
+
+            // Store edge 1 equation coefficients
+            pSIMDEERegs->m_SSEA4Edge1 = _mm_set_ps1(ee1.x);
+            pSIMDEERegs->m_SSEB4Edge1 = _mm_set_ps1(ee1.y);
+            pSIMDEERegs->m_SSEC4Edge1 = _mm_set_ps1(ee1.z);
+
+            // Store edge 2 equation coefficients
+            pSIMDEERegs->m_SSEA4Edge2 = _mm_set_ps1(ee2.x);
+            pSIMDEERegs->m_SSEB4Edge2 = _mm_set_ps1(ee2.y);
+            pSIMDEERegs->m_SSEC4Edge2 = _mm_set_ps1(ee2.z);
+
+            // F(x,y) = F0(x,y) + F1(x,y) + F2(x,y) is linear as well, so store its coefficients directly
+            pSIMDEERegs->m_SSEA4Sum = _mm_set_ps1(ee0.x + ee1.x + ee2.x);
+            pSIMDEERegs->m_SSEB4Sum = _mm_set_ps1(ee0.y + ee1.y + ee2.y);
+            pSIMDEERegs->m_SSEC4Sum = _mm_set_ps1(ee0.z + ee1.z + ee2.z);
+
+            pSIMDEERegs->m_SSEF0SampleOffsets = _mm_add_ps(_mm_mul_ps(pSIMDEERegs->m_SSEA4Edge0, sseSampleOffsetsX4), _mm_mul_ps(pSIMDEERegs->m_SSEB4Edge0, sseSampleOffsetsY4));
+            pSIMDEERegs->m_SSEF1SampleOffsets = _mm_add_ps(_mm_mul_ps(pSIMDEERegs->m_SSEA4Edge1, sseSampleOffsetsX4), _mm_mul_ps(pSIMDEERegs->m_SSEB4Edge1, sseSampleOffsetsY4));
+            pSIMDEERegs->m_SSEFSampleOffsets = _mm_add_ps(_mm_mul_ps(pSIMDEERegs->m_SSEA4Sum, sseSampleOffsetsX4), _mm_mul_ps(pSIMDEERegs->m_SSEB4Sum, sseSampleOffsetsY4));
+
+            pSIMDEERegs->m_SSEF0ColumnStep = _mm_mul_ps(pSIMDEERegs->m_SSEA4Edge0, sseColumnStep);
+            pSIMDEERegs->m_SSEF1ColumnStep = _mm_mul_ps(pSIMDEERegs->m_SSEA4Edge1, sseColumnStep);
+            pSIMDEERegs->m_SSEFColumnStep = _mm_mul_ps(pSIMDEERegs->m_SSEA4Sum, sseColumnStep);
+
+            pSIMDEERegs->m_SSEF0RowStep = _mm_mul_ps(pSIMDEERegs->m_SSEB4Edge0, sseRowStep);
+            pSIMDEERegs->m_SSEF1RowStep = _mm_mul_ps(pSIMDEERegs->m_SSEB4Edge1, sseRowStep);
+            pSIMDEERegs->m_SSEFRowStep = _mm_mul_ps(pSIMDEERegs->m_SSEB4Sum, sseRowStep);
+        }
+
+        // Z/W plane equation computed during triangle setup
+        const glm::vec3 zPlane = m_pDrawIteration->m_SetupBuffers.m_pDepthPlaneCoefficients[primIdx];
+
+        pSIMDEERegs->m_SSEA4Depth = _mm_set_ps1(zPlane.x);
+        pSIMDEERegs->m_SSEB4Depth = _mm_set_ps1(zPlane.y);
+        pSIMDEERegs->m_SSEC4Depth = _mm_set_ps1(zPlane.z);
+
+        pSIMDEERegs->m_SSEZSampleOffsets = _mm_add_ps(_mm_mul_ps(pSIMDEERegs->m_SSEA4Depth, sseSampleOffsetsX4), _mm_mul_ps(pSIMDEERegs->m_SSEB4Depth, sseSampleOffsetsY4));
+        pSIMDEERegs->m_SSEZColumnStep = _mm_mul_ps(pSIMDEERegs->m_SSEA4Depth, sseColumnStep);
+        pSIMDEERegs->m_SSEZRowStep = _mm_mul_ps(pSIMDEERegs->m_SSEB4Depth, sseRowStep);
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FragmentShadeTile(uint32_t tilePosX, uint32_t tilePosY, uint32_t primIdx, const SIMDEdgeCoefficients& simdEERegs)
+    {
+        const uint32_t numBlockInTile = m_RenderConfig.m_TileSize / g_scPixelBlockSize;
+
+        // Only block rows of the active sub-tile
+        for (uint32_t py = (m_SubTileMinY - tilePosY) / g_scPixelBlockSize; py < (m_SubTileMaxY - tilePosY) / g_scPixelBlockSize; py++)
+        {
+            for (uint32_t px = 0; px < numBlockInTile; px++)
+            {
+                FragmentShadeBlockLocked<Pipeline>(
+                    tilePosX + px * g_scPixelBlockSize,
+                    tilePosY + py * g_scPixelBlockSize,
+                    primIdx,
+                    simdEERegs);
+            }
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FragmentShadeBlockLocked(uint32_t blockPosX, uint32_t blockPosY, uint32_t primIdx, const SIMDEdgeCoefficients& simdEERegs)
+    {
+        // Block may be fragment-shaded by other threads concurrently in order-independent drawcalls, HiZ/depth test & writes must be atomic
+        if (m_pRenderEngine->m_IsOrderIndependent)
+        {
+            m_pRenderEngine->LockBlock(blockPosX, blockPosY);
+            FragmentShadeBlock<Pipeline>(blockPosX, blockPosY, primIdx, simdEERegs);
+            m_pRenderEngine->UnlockBlock(blockPosX, blockPosY);
+        }
+        else
+        {
+            FragmentShadeBlock<Pipeline>(blockPosX, blockPosY, primIdx, simdEERegs);
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FragmentShadeBlock(uint32_t blockPosX, uint32_t blockPosY, uint32_t primIdx, const SIMDEdgeCoefficients& simdEERegs)
+    {
+        if constexpr (Pipeline::s_HiZRejectionEnabled)
+        {
+            // Block is fully covered, so if the nearest Z of the primitive within block is behind the farthest depth of the block
+            // none of the samples can pass the depth test. Bias is there to keep the test conservative against rounding errors
+            static constexpr float scHiZRejectionBias = 1e-5f;
+
+            if (ComputeMinDepthValueInBlock(blockPosX, blockPosY, simdEERegs) > (m_pRenderEngine->FetchHiZValue(blockPosX, blockPosY) + scHiZRejectionBias))
+            {
+                LOG("Prim %d killed in HiZ test at block (%d, %d) by thread %d\n", primIdx, blockPosX, blockPosY, m_ThreadIdx);
+                return;
+            }
+        }
+
+        // Covered samples are filled with FS output evaluated once per primitive
+        const bool isOutputConstant = Pipeline::s_FragmentShaderEnabled && Pipeline::IsOutputConstantPerPrimitive(m_pRenderEngine);
+
+        // Shade all 64 samples with a single invocation if block FS is bound
+        if (Pipeline::s_FragmentShaderEnabled && Pipeline::HasBlockFragmentShader(m_pRenderEngine) && !isOutputConstant)
+        {
+            FragmentShadeBlockSoA<Pipeline>(blockPosX, blockPosY, primIdx, simdEERegs);
+            return;
+        }
+
+        auto FS = Pipeline::GetFragmentShader(m_pRenderEngine);
+        ASSERT(!Pipeline::s_FragmentShaderEnabled || Pipeline::HasFragmentShader(m_pRenderEngine) || isOutputConstant);
+
+        // Temp storage for interpolated vertex attributes
+        InterpolatedAttributes interpolatedAttribs;
+
+        // Parameter interpolation basis functions
+        __m128 ssef0XY, ssef1XY;
+
+        // 4-sample fragment colors
+        FragmentOutput fragmentOutput;
+
+        // Evaluate F0(x,y), F1(x,y), F(x,y) & Z(x,y) at the first SIMD group of the block once, then step from there
+        // Edge functions are only needed for attribute interpolation, so depth-only variants don't evaluate them at all
+        __m128 sseF0XYRow, sseF1XYRow, sseFXYRow;
+        if constexpr (Pipeline::s_FragmentShaderEnabled)
+        {
+            ComputeEdgeFunctionsAtSample(blockPosX, blockPosY, simdEERegs, &sseF0XYRow, &sseF1XYRow, &sseFXYRow);
+        }
+
+        __m128 sseZRow = ComputeDepthValuesAtSample(blockPosX, blockPosY, simdEERegs);
+
+        // Max depth of the block after depth test, to update HiZ with
+        __m128 sseBlockMaxDepth = _mm_setzero_ps();
+
+        // Loop over 8x8 pixels
+        for (uint32_t py = 0; py < g_scPixelBlockSize; py += g_scSampleGroupHeight)
+        {
+            __m128 sseF0XY, sseF1XY, sseFXY;
+            if constexpr (Pipeline::s_FragmentShaderEnabled)
+            {
+                sseF0XY = sseF0XYRow;
+                sseF1XY = sseF1XYRow;
+                sseFXY = sseFXYRow;
+
+                // Step to next row of SIMD groups
+                sseF0XYRow = _mm_add_ps(sseF0XYRow, simdEERegs.m_SSEF0RowStep);
+                sseF1XYRow = _mm_add_ps(sseF1XYRow, simdEERegs.m_SSEF1RowStep);
+                sseFXYRow = _mm_add_ps(sseFXYRow, simdEERegs.m_SSEFRowStep);
+            }
+
+            __m128 sseZInterpolated = sseZRow;
+            sseZRow = _mm_add_ps(sseZRow, simdEERegs.m_SSEZRowStep);
+
+            for (uint32_t px = 0; px < g_scPixelBlockSize; px += g_scSampleGroupWidth)
+            {
+                uint32_t sampleX = blockPosX + px;
+                uint32_t sampleY = blockPosY + py;
+
+                if (px > 0)
+                {
+                    // Step to next SIMD group in current row
+                    if constexpr (Pipeline::s_FragmentShaderEnabled)
+                    {
+                        sseF0XY = _mm_add_ps(sseF0XY, simdEERegs.m_SSEF0ColumnStep);
+                        sseF1XY = _mm_add_ps(sseF1XY, simdEERegs.m_SSEF1ColumnStep);
+                        sseFXY = _mm_add_ps(sseFXY, simdEERegs.m_SSEFColumnStep);
+                    }
+
+                    sseZInterpolated = _mm_add_ps(sseZInterpolated, simdEERegs.m_SSEZColumnStep);
+                }
+
+                // Perform depth test of bound pipeline state
+                __m128 sseDepthResolved;
+                __m128 sseDepthRes = PerformDepthTest<Pipeline>(sseZInterpolated, sampleX, sampleY, &sseDepthResolved);
+
+                // Keep track of resulting depth values
+                sseBlockMaxDepth = _mm_max_ps(sseBlockMaxDepth, sseDepthResolved);
+
+                if constexpr (!Pipeline::s_FragmentShaderEnabled)
+                {
+                    // Depth-only: all samples are covered and resolved depth holds current contents for those failing depth test,
+                    // so it can be stored as is without any branching or masking
+                    if constexpr (Pipeline::s_DepthWriteEnabled)
+                    {
+                        m_pRenderEngine->StoreDepthBuffer(sseDepthResolved, sampleX, sampleY);
+                    }
+                    continue;
+                }
+
+                // Apply Early-Z test for block/tiles only!
+                if (_mm_movemask_ps(sseDepthRes) == 0x0)
+                {
+                    LOG("Prim %d killed in Early-Z optimization at (%d, %d) by thread %d\n", primIdx, sampleX, sampleY, m_ThreadIdx);
+
+                    // No sample being processed passes depth test, skip invoking FS altogether
+                    continue;
+                }
+
+                if (Pipeline::ReadsSubpassInput(m_pRenderEngine))
+                {
+                    // Subpass inputs are contents before the primitive is written
+                    FetchSubpassInput(sampleX, sampleY, &interpolatedAttribs);
+                }
+
+                if constexpr (Pipeline::s_DepthWriteEnabled)
+                {
+                    // Write interpolated Z values, merged with current contents already
+                    m_pRenderEngine->StoreDepthBuffer(sseDepthResolved, sampleX, sampleY);
+                }
+
+                if (isOutputConstant)
+                {
+                    // Fill samples passing depth test with FS output of the primitive
+                    m_pRenderEngine->UpdateColorBufferRGBA8<Pipeline::s_ColorWriteMode == ColorWriteMode::MASKED>(
+                        sseDepthRes, FetchConstantFragmentOutput<Pipeline>(primIdx, sampleX, sampleY, simdEERegs), sampleX, sampleY);
+                    continue;
+                }
+
+                if (Pipeline::HasInterpolatedAttributes(m_pRenderEngine))
+                {
+                    // Calculate basis functions f0(x,y) & f1(x,y) once
+                    ComputeParameterBasisFunctions(
+                        sseF0XY,
+                        sseF1XY,
+                        sseFXY,
+                        &ssef0XY,
+                        &ssef1XY);
+
+                    // Interpolate active vertex attributes
+                    InterpolateVertexAttributes<Pipeline>(primIdx, ssef0XY, ssef1XY, &interpolatedAttribs);
+                }
+
+                // Invoke FS and update color buffer with fragment output
+                FS(&interpolatedAttribs, m_pRenderEngine->m_pConstantBuffer, &fragmentOutput);
+
+                // Write fragment output
+                m_pRenderEngine->UpdateColorBuffer<Pipeline::s_ColorWriteMode == ColorWriteMode::MASKED>(sseDepthRes, fragmentOutput, sampleX, sampleY);
+            }
+        }
+
+        if constexpr (g_scHiZEnabled && Pipeline::s_DepthWriteEnabled)
+        {
+            // All samples of the block were visited, so max depth is exact now
+            m_pRenderEngine->UpdateHiZValue(HorizontalMax(sseBlockMaxDepth), blockPosX, blockPosY);
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FragmentShadeQuad(CoverageMask* pMask, const SIMDEdgeCoefficients& simdEERegs)
+    {
+        ASSERT(pMask != nullptr);
+
+        auto FS = Pipeline::GetFragmentShader(m_pRenderEngine);
+        auto blockFS = Pipeline::GetBlockFragmentShader(m_pRenderEngine);
+        ASSERT(!Pipeline::s_FragmentShaderEnabled || Pipeline::HasFragmentShader(m_pRenderEngine) || Pipeline::HasBlockFragmentShader(m_pRenderEngine));
+
+        // Compute depth values prior to depth test, independent of basis functions
+        __m128 sseZInterpolated = ComputeDepthValuesAtSample(pMask->m_SampleX, pMask->m_SampleY, simdEERegs);
+
+        // Perform depth test of bound pipeline state
+        __m128 sseDepthResolved;
+        __m128 sseDepthRes = PerformDepthTest<Pipeline>(sseZInterpolated, pMask->m_SampleX, pMask->m_SampleY, &sseDepthResolved);
+
+        // Generate color mask from 4-bit int mask set during rasterization
+        __m128i sseColorMask = _mm_setr_epi32(
+            pMask->m_QuadMask & g_scQuadMask0,
+            pMask->m_QuadMask & g_scQuadMask1,
+            pMask->m_QuadMask & g_scQuadMask2,
+            pMask->m_QuadMask & g_scQuadMask3);
+
+        sseColorMask = _mm_cmpeq_epi32(sseColorMask,
+            _mm_set_epi64x(0x800000004, 0x200000001));
+
+        // AND depth mask & coverage mask for quads of fragments
+        __m128 sseWriteMask = _mm_and_ps(sseDepthRes, _mm_castsi128_ps(sseColorMask));
+
+        // Since depth no longer needs basis functions, covered samples failing depth test can skip FS altogether
+        if (_mm_movemask_ps(sseWriteMask) == 0x0)
+        {
+            LOG("Prim %d killed in Early-Z optimization at (%d, %d) by thread %d\n", pMask->m_PrimIdx, pMask->m_SampleX, pMask->m_SampleY, m_ThreadIdx);
+            return;
+        }
+
+        // Vertex attributes to be interpolated and passed to FS
+        InterpolatedAttributes interpolatedAttribs;
+
+        if (Pipeline::s_FragmentShaderEnabled && Pipeline::ReadsSubpassInput(m_pRenderEngine))
+        {
+            // Subpass inputs are contents before the primitive is written
+            FetchSubpassInput(pMask->m_SampleX, pMask->m_SampleY, &interpolatedAttribs);
+        }
+
+        if constexpr (Pipeline::s_DepthWriteEnabled)
+        {
+            // Depth doesn't depend on FS output, so Z values can be written right away
+            m_pRenderEngine->UpdateDepthBuffer(sseWriteMask, sseZInterpolated, pMask->m_SampleX, pMask->m_SampleY);
+        }
+
+        if constexpr (Pipeline::s_HiZRaiseEnabled)
+        {
+            // Written Z values may exceed max depth of the block, which must stay conservative
+            const float maxDepthWritten = HorizontalMax(_mm_blendv_ps(_mm_set1_ps(-FLT_MAX), sseZInterpolated, sseWriteMask));
+            m_pRenderEngine->UpdateHiZValue(std::max(maxDepthWritten, m_pRenderEngine->FetchHiZValue(pMask->m_SampleX, pMask->m_SampleY)), pMask->m_SampleX, pMask->m_SampleY);
+        }
+
+        if constexpr (!Pipeline::s_FragmentShaderEnabled)
+        {
+            // No color output, so no need to invoke FS
+            return;
+        }
+
+        if (Pipeline::IsOutputConstantPerPrimitive(m_pRenderEngine))
+        {
+            // Fill covered samples passing depth test with FS output of the primitive, no need to pack fragments either
+            m_pRenderEngine->UpdateColorBufferRGBA8<Pipeline::s_ColorWriteMode == ColorWriteMode::MASKED>(
+                sseWriteMask, FetchConstantFragmentOutput<Pipeline>(pMask->m_PrimIdx, pMask->m_SampleX, pMask->m_SampleY, simdEERegs), pMask->m_SampleX, pMask->m_SampleY);
+            return;
+        }
+
+        if (Pipeline::HasInterpolatedAttributes(m_pRenderEngine))
+        {
+            // Parameter interpolation basis functions
+            __m128 ssef0XY, ssef1XY;
+
+            // Evaluate F0(x,y), F1(x,y) & F(x,y) at 4 samples of the SIMD group
+            __m128 sseF0XY, sseF1XY, sseFXY;
+            ComputeEdgeFunctionsAtSample(pMask->m_SampleX, pMask->m_SampleY, simdEERegs, &sseF0XY, &sseF1XY, &sseFXY);
+
+            // Calculate basis functions f0(x,y) & f1(x,y) once
+            ComputeParameterBasisFunctions(
+                sseF0XY,
+                sseF1XY,
+                sseFXY,
+                &ssef0XY,
+                &ssef1XY);
+
+            // Interpolate active vertex attributes
+            InterpolateVertexAttributes<Pipeline>(pMask->m_PrimIdx, ssef0XY, ssef1XY, &interpolatedAttribs);
+        }
+
+        if constexpr (g_scFragmentPackingEnabled)
+        {
+            const int writeMask = _mm_movemask_ps(sseWriteMask);
+
+            // Only partially live SIMD groups are packed, and only if FS doesn't take derivatives which would be computed across unrelated samples.
+            // Subpass inputs of packed fragments could be overwritten by fragments packed before them, so such FS isn't packed.
+            // Neither are fragments of order-independent drawcalls, whose deferred color writes would escape the lock of their block
+            if (Pipeline::HasFragmentShader(m_pRenderEngine) && !Pipeline::TakesDerivatives(m_pRenderEngine) && !Pipeline::ReadsSubpassInput(m_pRenderEngine) &&
+                !m_pRenderEngine->m_IsOrderIndependent)
+            {
+                if (writeMask != 0xF)
+                {
+                    // Only FS + color writes are deferred
+                    PackFragments<Pipeline>(writeMask, pMask->m_SampleX, pMask->m_SampleY, interpolatedAttribs);
+                    return;
+                }
+
+                // Fully live quad is fragment-shaded as is, after packed fragments whose color writes must precede its own
+                FlushPackedFragments<Pipeline>();
+            }
+        }
+
+        // 4-sample fragment colors
+        FragmentOutput fragmentOutput;
+
+        if (Pipeline::HasFragmentShader(m_pRenderEngine))
+        {
+            // Invoke FS and update color buffer with fragment output
+            FS(&interpolatedAttribs, m_pRenderEngine->m_pConstantBuffer, &fragmentOutput);
+        }
+        else
+        {
+            // Only block FS is bound, so invoke it with a single live SIMD group
+            StoreBlockInterpolatedAttributes<Pipeline>(0, interpolatedAttribs);
+
+            blockFS(&m_BlockInterpolatedAttributes, m_pRenderEngine->m_pConstantBuffer, static_cast<uint64_t>(_mm_movemask_ps(sseWriteMask)), &m_BlockFragmentOutput);
+
+            LoadBlockFragmentOutput(0, &fragmentOutput);
+        }
+
+        // Write fragment output
+        m_pRenderEngine->UpdateColorBuffer<Pipeline::s_ColorWriteMode == ColorWriteMode::MASKED>(sseWriteMask, fragmentOutput, pMask->m_SampleX, pMask->m_SampleY);
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FragmentShadeBlockSoA(uint32_t blockPosX, uint32_t blockPosY, uint32_t primIdx, const SIMDEdgeCoefficients& simdEERegs)
+    {
+        auto blockFS = Pipeline::GetBlockFragmentShader(m_pRenderEngine);
+        ASSERT(Pipeline::HasBlockFragmentShader(m_pRenderEngine));
+
+        // Temp storage for interpolated vertex attributes of a SIMD group
+        InterpolatedAttributes interpolatedAttribs;
+
+        // Parameter interpolation basis functions
+        __m128 ssef0XY, ssef1XY;
+
+        // Depth test results of all SIMD groups, which will be used to write FS output
+        __m128 sseWriteMasks[g_scNumSampleGroupsPerBlock];
+
+        // Bit i set if sample i passed depth test
+        uint64_t liveMask = 0ull;
+
+        // Evaluate F0(x,y), F1(x,y), F(x,y) & Z(x,y) at the first SIMD group of the block once, then step from there
+        __m128 sseF0XYRow, sseF1XYRow, sseFXYRow;
+        ComputeEdgeFunctionsAtSample(blockPosX, blockPosY, simdEERegs, &sseF0XYRow, &sseF1XYRow, &sseFXYRow);
+
+        __m128 sseZRow = ComputeDepthValuesAtSample(blockPosX, blockPosY, simdEERegs);
+
+        // Max depth of the block after depth test, to update HiZ with
+        __m128 sseBlockMaxDepth = _mm_setzero_ps();
+
+        // Depth test and interpolate attributes of all SIMD groups first, so that block FS sees the whole block at once
+        uint32_t sampleGroupIdx = 0;
+        for (uint32_t py = 0; py < g_scPixelBlockSize; py += g_scSampleGroupHeight)
+        {
+            __m128 sseF0XY = sseF0XYRow;
+            __m128 sseF1XY = sseF1XYRow;
+            __m128 sseFXY = sseFXYRow;
+            __m128 sseZInterpolated = sseZRow;
+
+            // Step to next row of SIMD groups
+            sseF0XYRow = _mm_add_ps(sseF0XYRow, simdEERegs.m_SSEF0RowStep);
+            sseF1XYRow = _mm_add_ps(sseF1XYRow, simdEERegs.m_SSEF1RowStep);
+            sseFXYRow = _mm_add_ps(sseFXYRow, simdEERegs.m_SSEFRowStep);
+            sseZRow = _mm_add_ps(sseZRow, simdEERegs.m_SSEZRowStep);
+
+            for (uint32_t px = 0; px < g_scPixelBlockSize; px += g_scSampleGroupWidth, sampleGroupIdx++)
+            {
+                uint32_t sampleX = blockPosX + px;
+                uint32_t sampleY = blockPosY + py;
+
+                if (px > 0)
+                {
+                    // Step to next SIMD group in current row
+                    sseF0XY = _mm_add_ps(sseF0XY, simdEERegs.m_SSEF0ColumnStep);
+                    sseF1XY = _mm_add_ps(sseF1XY, simdEERegs.m_SSEF1ColumnStep);
+                    sseFXY = _mm_add_ps(sseFXY, simdEERegs.m_SSEFColumnStep);
+                    sseZInterpolated = _mm_add_ps(sseZInterpolated, simdEERegs.m_SSEZColumnStep);
+                }
+
+                // Perform depth test of bound pipeline state
+                __m128 sseDepthResolved;
+                __m128 sseDepthRes = PerformDepthTest<Pipeline>(sseZInterpolated, sampleX, sampleY, &sseDepthResolved);
+
+                // Keep track of resulting depth values
+                sseBlockMaxDepth = _mm_max_ps(sseBlockMaxDepth, sseDepthResolved);
+
+                sseWriteMasks[sampleGroupIdx] = sseDepthRes;
+
+                const int depthMask = _mm_movemask_ps(sseDepthRes);
+                if (depthMask == 0x0)
+                {
+                    // No sample of the SIMD group passes depth test, no need to interpolate attributes either
+                    continue;
+                }
+
+                liveMask |= static_cast<uint64_t>(depthMask) << (sampleGroupIdx * g_scSIMDWidth);
+
+                if constexpr (Pipeline::s_DepthWriteEnabled)
+                {
+                    // No FS-side depth modification, so Z values can be written right away
+                    m_pRenderEngine->UpdateDepthBuffer(sseDepthRes, sseZInterpolated, sampleX, sampleY);
+                }
+
+                if (Pipeline::HasInterpolatedAttributes(m_pRenderEngine))
+                {
+                    // Calculate basis functions f0(x,y) & f1(x,y) once
+                    ComputeParameterBasisFunctions(
+                        sseF0XY,
+                        sseF1XY,
+                        sseFXY,
+                        &ssef0XY,
+                        &ssef1XY);
+
+                    // Interpolate active vertex attributes and scatter them to block FS input
+                    InterpolateVertexAttributes<Pipeline>(primIdx, ssef0XY, ssef1XY, &interpolatedAttribs);
+                    StoreBlockInterpolatedAttributes<Pipeline>(sampleGroupIdx, interpolatedAttribs);
+                }
+            }
+        }
+
+        if constexpr (g_scHiZEnabled && Pipeline::s_DepthWriteEnabled)
+        {
+            // All samples of the block were visited, so max depth is exact now
+            m_pRenderEngine->UpdateHiZValue(HorizontalMax(sseBlockMaxDepth), blockPosX, blockPosY);
+        }
+
+        if (liveMask == 0ull)
+        {
+            LOG("Prim %d killed in Early-Z optimization at block (%d, %d) by thread %d\n", primIdx, blockPosX, blockPosY, m_ThreadIdx);
+            return;
+        }
+
+        // Invoke block FS once for all live samples
+        blockFS(&m_BlockInterpolatedAttributes, m_pRenderEngine->m_pConstantBuffer, liveMask, &m_BlockFragmentOutput);
+
+        // 4-sample fragment colors
+        FragmentOutput fragmentOutput;
+
+        // Write fragment output of SIMD groups with live samples
+        for (uint32_t i = 0; i < g_scNumSampleGroupsPerBlock; i++)
+        {
+            if (((liveMask >> (i * g_scSIMDWidth)) & 0xF) == 0x0)
+            {
+                continue;
+            }
+
+            uint32_t sampleX = blockPosX + (i % g_scNumEdgeTestsPerRow) * g_scSampleGroupWidth;
+            uint32_t sampleY = blockPosY + (i / g_scNumEdgeTestsPerRow) * g_scSampleGroupHeight;
+
+            LoadBlockFragmentOutput(i, &fragmentOutput);
+            m_pRenderEngine->UpdateColorBuffer<Pipeline::s_ColorWriteMode == ColorWriteMode::MASKED>(sseWriteMasks[i], fragmentOutput, sampleX, sampleY);
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::PackFragments(int liveMask, uint32_t sampleX, uint32_t sampleY, const InterpolatedAttributes& interpolatedAttributes)
+    {
+        for (uint32_t lane = 0; lane < g_scSIMDWidth; lane++)
+        {
+            if ((liveMask & (1 << lane)) == 0)
+            {
+                continue;
+            }
+
+            const uint32_t slot = m_NumPackedFragments;
+            ASSERT(slot < g_scSIMDWidth);
+
+            // Copy interpolated attributes of live lane to next free lane of the packed SIMD group
+            for (uint32_t i = 0; i < Pipeline::NumVec4Attributes(m_pRenderEngine); i++)
+            {
+                m_PackedAttributes.m_Vec4Attributes[i].m_VecX[slot] = interpolatedAttributes.m_Vec4Attributes[i].m_VecX[lane];
+                m_PackedAttributes.m_Vec4Attributes[i].m_VecY[slot] = interpolatedAttributes.m_Vec4Attributes[i].m_VecY[lane];
+                m_PackedAttributes.m_Vec4Attributes[i].m_VecZ[slot] = interpolatedAttributes.m_Vec4Attributes[i].m_VecZ[lane];
+                m_PackedAttributes.m_Vec4Attributes[i].m_VecW[slot] = interpolatedAttributes.m_Vec4Attributes[i].m_VecW[lane];
+            }
+
+            for (uint32_t i = 0; i < Pipeline::NumVec3Attributes(m_pRenderEngine); i++)
+            {
+                m_PackedAttributes.m_Vec3Attributes[i].m_VecX[slot] = interpolatedAttributes.m_Vec3Attributes[i].m_VecX[lane];
+                m_PackedAttributes.m_Vec3Attributes[i].m_VecY[slot] = interpolatedAttributes.m_Vec3Attributes[i].m_VecY[lane];
+                m_PackedAttributes.m_Vec3Attributes[i].m_VecZ[slot] = interpolatedAttributes.m_Vec3Attributes[i].m_VecZ[lane];
+            }
+
+            for (uint32_t i = 0; i < Pipeline::NumVec2Attributes(m_pRenderEngine); i++)
+            {
+                m_PackedAttributes.m_Vec2Attributes[i].m_VecX[slot] = interpolatedAttributes.m_Vec2Attributes[i].m_VecX[lane];
+                m_PackedAttributes.m_Vec2Attributes[i].m_VecY[slot] = interpolatedAttributes.m_Vec2Attributes[i].m_VecY[lane];
+            }
+
+            m_PackedSampleX[slot] = sampleX + static_cast<uint32_t>(g_scSampleGroupOffsets.m_X[lane]);
+            m_PackedSampleY[slot] = sampleY + static_cast<uint32_t>(g_scSampleGroupOffsets.m_Y[lane]);
+
+            if (++m_NumPackedFragments == g_scSIMDWidth)
+            {
+                FlushPackedFragments<Pipeline>();
+            }
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::FlushPackedFragments()
+    {
+        if (m_NumPackedFragments == 0u)
+        {
+            return;
+        }
+
+        auto FS = Pipeline::GetFragmentShader(m_pRenderEngine);
+        ASSERT(Pipeline::HasFragmentShader(m_pRenderEngine));
+
+        // 4-sample fragment colors
+        FragmentOutput fragmentOutput;
+
+        // Unused lanes (if any) carry stale attributes, their outputs are simply dropped
+        FS(&m_PackedAttributes, m_pRenderEngine->m_pConstantBuffer, &fragmentOutput);
+
+        // Write fragment output in packing order, so that overlapping fragments resolve in primitive order
+        for (uint32_t slot = 0; slot < m_NumPackedFragments; slot++)
+        {
+            m_pRenderEngine->UpdateColorBuffer<Pipeline::s_ColorWriteMode == ColorWriteMode::MASKED>(fragmentOutput.m_FragmentColors[slot], m_PackedSampleX[slot], m_PackedSampleY[slot]);
+        }
+
+        m_NumPackedFragments = 0u;
+    }
+
+    template<typename Pipeline>
+    __m128i PipelineThread::FetchConstantFragmentOutput(uint32_t primIdx, uint32_t sampleX, uint32_t sampleY, const SIMDEdgeCoefficients& simdEERegs)
+    {
+        if (primIdx == m_ConstantFragmentOutputPrimIdx)
+        {
+            return m_SSEConstantFragmentOutput;
+        }
+
+        // Vertex attributes to be interpolated and passed to FS
+        InterpolatedAttributes interpolatedAttribs;
+
+        if (Pipeline::HasInterpolatedAttributes(m_pRenderEngine))
+        {
+            // Parameter interpolation basis functions
+            __m128 ssef0XY, ssef1XY;
+
+            // Evaluate F0(x,y), F1(x,y) & F(x,y) at 4 samples of the SIMD group
+            __m128 sseF0XY, sseF1XY, sseFXY;
+            ComputeEdgeFunctionsAtSample(sampleX, sampleY, simdEERegs, &sseF0XY, &sseF1XY, &sseFXY);
+
+            ComputeParameterBasisFunctions(
+                sseF0XY,
+                sseF1XY,
+                sseFXY,
+                &ssef0XY,
+                &ssef1XY);
+
+            InterpolateVertexAttributes<Pipeline>(primIdx, ssef0XY, ssef1XY, &interpolatedAttribs);
+        }
+
+        // 4-sample fragment colors, which are all the same
+        FragmentOutput fragmentOutput;
+
+        if (Pipeline::HasFragmentShader(m_pRenderEngine))
+        {
+            auto FS = Pipeline::GetFragmentShader(m_pRenderEngine);
+            FS(&interpolatedAttribs, m_pRenderEngine->m_pConstantBuffer, &fragmentOutput);
+        }
+        else
+        {
+            // Only block FS is bound, so invoke it with a single live sample
+            auto blockFS = Pipeline::GetBlockFragmentShader(m_pRenderEngine);
+            ASSERT(Pipeline::HasBlockFragmentShader(m_pRenderEngine));
+
+            StoreBlockInterpolatedAttributes<Pipeline>(0, interpolatedAttribs);
+
+            blockFS(&m_BlockInterpolatedAttributes, m_pRenderEngine->m_pConstantBuffer, 0x1ull, &m_BlockFragmentOutput);
+
+            LoadBlockFragmentOutput(0, &fragmentOutput);
+        }
+
+        // rgba = cast<uint>(rgba * 255.f), packed down to 8 bits and broadcast to 4 samples
+        __m128i sseSample = _mm_cvtps_epi32(_mm_mul_ps(fragmentOutput.m_FragmentColors[0], _mm_set1_ps(255.f)));
+        sseSample = _mm_packus_epi32(sseSample, sseSample);
+        sseSample = _mm_packus_epi16(sseSample, sseSample);
+
+        m_SSEConstantFragmentOutput = _mm_shuffle_epi32(sseSample, _MM_SHUFFLE(0, 0, 0, 0));
+        m_ConstantFragmentOutputPrimIdx = primIdx;
+
+        return m_SSEConstantFragmentOutput;
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::StoreBlockInterpolatedAttributes(uint32_t sampleGroupIdx, const InterpolatedAttributes& interpolatedAttributes)
+    {
+        ASSERT(sampleGroupIdx < g_scNumSampleGroupsPerBlock);
+
+        const uint32_t offset = sampleGroupIdx * g_scSIMDWidth;
+
+        for (uint32_t i = 0; i < Pipeline::NumVec4Attributes(m_pRenderEngine); i++)
+        {
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec4Attributes[i].m_X[offset], interpolatedAttributes.m_Vec4Attributes[i].m_SSEX);
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec4Attributes[i].m_Y[offset], interpolatedAttributes.m_Vec4Attributes[i].m_SSEY);
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec4Attributes[i].m_Z[offset], interpolatedAttributes.m_Vec4Attributes[i].m_SSEZ);
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec4Attributes[i].m_W[offset], interpolatedAttributes.m_Vec4Attributes[i].m_SSEW);
+        }
+
+        for (uint32_t i = 0; i < Pipeline::NumVec3Attributes(m_pRenderEngine); i++)
+        {
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec3Attributes[i].m_X[offset], interpolatedAttributes.m_Vec3Attributes[i].m_SSEX);
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec3Attributes[i].m_Y[offset], interpolatedAttributes.m_Vec3Attributes[i].m_SSEY);
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec3Attributes[i].m_Z[offset], interpolatedAttributes.m_Vec3Attributes[i].m_SSEZ);
+        }
+
+        for (uint32_t i = 0; i < Pipeline::NumVec2Attributes(m_pRenderEngine); i++)
+        {
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec2Attributes[i].m_X[offset], interpolatedAttributes.m_Vec2Attributes[i].m_SSEX);
+            _mm_store_ps(&m_BlockInterpolatedAttributes.m_Vec2Attributes[i].m_Y[offset], interpolatedAttributes.m_Vec2Attributes[i].m_SSEY);
+        }
+    }
+
+    template<typename Pipeline>
+    void PipelineThread::InterpolateVertexAttributes(
+        uint32_t primIdx,
+        const __m128& ssef0XY,
+        const __m128& ssef1XY,
+        InterpolatedAttributes* pInterpolatedAttributes)
+    {
+        // vec4 xyzw attributes
+        for (uint32_t i = 0; i < Pipeline::NumVec4Attributes(m_pRenderEngine); i++)
+        {
+            // Fetch interpolation deltas computed after VS was returned
+            const glm::vec3& attrib0Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 0];
+            const glm::vec3& attrib1Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 1];
+            const glm::vec3& attrib2Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 2];
+            const glm::vec3& attrib3Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute4Deltas[i][primIdx * 4 + 3];
+
+            // vec4::x attribute to be interpolated
+            __m128 sseAttrib0X = _mm_set_ps1(attrib0Vec3.x);
+            __m128 sseAttrib1X = _mm_set_ps1(attrib0Vec3.y);
+            __m128 sseAttrib2X = _mm_set_ps1(attrib0Vec3.z);
+
+            __m128 sseVec4AttribX = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0X, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1X, ssef1XY), sseAttrib2X));
+
+            // vec4::y attribute to be interpolated
+            __m128 sseAttrib0Y = _mm_set_ps1(attrib1Vec3.x);
+            __m128 sseAttrib1Y = _mm_set_ps1(attrib1Vec3.y);
+            __m128 sseAttrib2Y = _mm_set_ps1(attrib1Vec3.z);
+
+            __m128 sseVec4AttribY = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0Y, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1Y, ssef1XY), sseAttrib2Y));
+
+            // vec4::z attribute to be interpolated
+            __m128 sseAttrib0Z = _mm_set_ps1(attrib2Vec3.x);
+            __m128 sseAttrib1Z = _mm_set_ps1(attrib2Vec3.y);
+            __m128 sseAttrib2Z = _mm_set_ps1(attrib2Vec3.z);
+
+            __m128 sseVec4AttribZ = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0Z, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1Z, ssef1XY), sseAttrib2Z));
+
+            // vec4::w attribute to be interpolated
+            __m128 sseAttrib0W = _mm_set_ps1(attrib3Vec3.x);
+            __m128 sseAttrib1W = _mm_set_ps1(attrib3Vec3.y);
+            __m128 sseAttrib2W = _mm_set_ps1(attrib3Vec3.z);
+
+            __m128 sseVec3AttribW = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0W, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1W, ssef1XY), sseAttrib2W));
+
+            pInterpolatedAttributes->m_Vec4Attributes[i].m_SSEX = sseVec4AttribX;
+            pInterpolatedAttributes->m_Vec4Attributes[i].m_SSEY = sseVec4AttribY;
+            pInterpolatedAttributes->m_Vec4Attributes[i].m_SSEZ = sseVec4AttribZ;
+            pInterpolatedAttributes->m_Vec4Attributes[i].m_SSEW = sseVec3AttribW;
+        }
+
+        // vec3 xyz attributes
+        for (uint32_t i = 0; i < Pipeline::NumVec3Attributes(m_pRenderEngine); i++)
+        {
+            // Fetch interpolation deltas computed after VS was returned
+            const glm::vec3& attrib0Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute3Deltas[i][primIdx * 3 + 0];
+            const glm::vec3& attrib1Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute3Deltas[i][primIdx * 3 + 1];
+            const glm::vec3& attrib2Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute3Deltas[i][primIdx * 3 + 2];
+
+            // vec3::x attribute to be interpolated
+            __m128 sseAttrib0X = _mm_set_ps1(attrib0Vec3.x);
+            __m128 sseAttrib1X = _mm_set_ps1(attrib0Vec3.y);
+            __m128 sseAttrib2X = _mm_set_ps1(attrib0Vec3.z);
+
+            __m128 sseVec3AttribX = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0X, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1X, ssef1XY), sseAttrib2X));
+
+            // vec3::y attribute to be interpolated
+            __m128 sseAttrib0Y = _mm_set_ps1(attrib1Vec3.x);
+            __m128 sseAttrib1Y = _mm_set_ps1(attrib1Vec3.y);
+            __m128 sseAttrib2Y = _mm_set_ps1(attrib1Vec3.z);
+
+            __m128 sseVec3AttribY = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0Y, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1Y, ssef1XY), sseAttrib2Y));
+
+            // vec3::z attribute to be interpolated
+            __m128 sseAttrib0Z = _mm_set_ps1(attrib2Vec3.x);
+            __m128 sseAttrib1Z = _mm_set_ps1(attrib2Vec3.y);
+            __m128 sseAttrib2Z = _mm_set_ps1(attrib2Vec3.z);
+
+            __m128 sseVec3AttribZ = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0Z, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1Z, ssef1XY), sseAttrib2Z));
+
+            pInterpolatedAttributes->m_Vec3Attributes[i].m_SSEX = sseVec3AttribX;
+            pInterpolatedAttributes->m_Vec3Attributes[i].m_SSEY = sseVec3AttribY;
+            pInterpolatedAttributes->m_Vec3Attributes[i].m_SSEZ = sseVec3AttribZ;
+        }
+
+        // vec2 xy attributes
+        for (uint32_t i = 0; i < Pipeline::NumVec2Attributes(m_pRenderEngine); i++)
+        {
+            // Fetch interpolation deltas computed after VS was returned
+            const glm::vec3& attrib0Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute2Deltas[i][primIdx * 2 + 0];
+            const glm::vec3& attrib1Vec3 = m_pDrawIteration->m_SetupBuffers.m_Attribute2Deltas[i][primIdx * 2 + 1];
+
+            // vec3::x attribute to be interpolated
+            __m128 sseAttrib0X = _mm_set_ps1(attrib0Vec3.x);
+            __m128 sseAttrib1X = _mm_set_ps1(attrib0Vec3.y);
+            __m128 sseAttrib2X = _mm_set_ps1(attrib0Vec3.z);
+
+            __m128 sseVec2AttribX = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0X, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1X, ssef1XY), sseAttrib2X));
+
+            // vec3::y attribute to be interpolated
+            __m128 sseAttrib0Y = _mm_set_ps1(attrib1Vec3.x);
+            __m128 sseAttrib1Y = _mm_set_ps1(attrib1Vec3.y);
+            __m128 sseAttrib2Y = _mm_set_ps1(attrib1Vec3.z);
+
+            __m128 sseVec2AttribY = _mm_add_ps(
+                _mm_mul_ps(sseAttrib0Y, ssef0XY),
+                _mm_add_ps(_mm_mul_ps(sseAttrib1Y, ssef1XY), sseAttrib2Y));
+
+            pInterpolatedAttributes->m_Vec2Attributes[i].m_SSEX = sseVec2AttribX;
+            pInterpolatedAttributes->m_Vec2Attributes[i].m_SSEY = sseVec2AttribY;
+        }
+    }
+}
\ No newline at end of file
@@ -10,6 +10,72 @@ namespace tyler
     // Toggle VS$
     static constexpr bool       g_scVertexShaderCacheEnabled = true;
 
+    // Toggle per-block max depth (HiZ) test to reject fully covered blocks before fragment shading
+    static constexpr bool       g_scHiZEnabled = true;
+
+    // Toggle tile-sized color/depth buffers which the fragment stage works on instead of the framebuffer.
+    // A tile's buffers are loaded (or cleared) on first use in a render pass and resolved to the framebuffer once at the end of it.
+    // Tiles stay resident for a whole render pass and may be shaded by any thread, so buffers of all tiles are allocated at once.
+    // They make up a second full-size RGBA8 + D32 surface (8 bytes/sample, ~66MB at 3840x2160) rather than cache-resident scratch memory,
+    // and add one framebuffer read per loaded tile and one framebuffer write per resolved tile to each render pass
+    static constexpr bool       g_scTileBuffersEnabled = true;
+
+    // Toggle fused rasterization & fragment shading: a thread dequeuing a tile rasterizes primitives binned for it one at a time
+    // and fragment-shades coverage masks of each right away from a small per-thread buffer, so a tile is only touched by a single thread in a draw iteration
+    static constexpr bool       g_scFusedRasterShadeEnabled = false;
+
+    // Toggle dynamic distribution of geometry processing: threads fetch batches of g_scGeometryBatchSize primitives of a draw iteration from a shared cursor,
+    // instead of each processing an equal contiguous range of it. Per-thread bins of a tile are merged by primitive index to rasterize primitives in order
+    static constexpr bool       g_scDynamicGeometryDistributionEnabled = true;
+    static constexpr uint32_t   g_scGeometryBatchSize = 32u;
+
+    // Binner emits TILE coverage masks of trivially accepted tiles right away, instead of flagging primitives in bins (see g_scBinnedPrimTrivialAcceptFlag)
+    static constexpr bool       g_scBinnerEmitsTrivialAcceptMasks = !g_scFusedRasterShadeEnabled && !g_scDynamicGeometryDistributionEnabled;
+
+    // Order tiles of a draw iteration are dispatched in for rasterization & fragment shading, which the tile queue is rebuilt in once all tiles are binned
+    enum class TileDispatchOrder : uint32_t
+    {
+        BINNING,        // Order tiles received their first primitive in, no reordering
+        ROW_MAJOR,      // Row-major over tile coordinates
+        MORTON,         // Z-order curve over tile coordinates
+        HILBERT,        // Hilbert curve over tile coordinates, consecutive tiles are always adjacent on screen
+        SCREEN_REGION   // Screen is split into a horizontal band per thread, tiles of bands (in row-major order) are interleaved so that tiles dispatched together fall in separate bands
+    };
+
+    // Active tile dispatch order, so that tiles processed at around the same time share texture & framebuffer data in caches.
+    // If g_scCostAwareTileSchedulingEnabled, tiles are dispatched heaviest-first by cost class (power of two of estimated cost) and in this order within each class
+    static constexpr TileDispatchOrder g_scTileDispatchOrder = TileDispatchOrder::HILBERT;
+
+    // Toggle cost-aware tile scheduling: once all primitives of a draw iteration are binned, queued tiles are sorted by their estimated cost
+    // (# primitives binned for them, each trivially accepting one weighted by the # blocks in a tile as it fragment-shades all of them)
+    // so that the heaviest tiles are rasterized & fragment-shaded first,
+    // instead of in the order they were first binned which may leave a single thread busy with a heavy tile at the end of the draw iteration
+    static constexpr bool       g_scCostAwareTileSchedulingEnabled = true;
+
+    // Toggle splitting of heavy tiles into up to g_scMaxSubTilesPerTile sub-tiles of consecutive block rows when queued tiles are scheduled by cost,
+    // each of which is queued separately to be fragment-shaded (and rasterized if g_scFusedRasterShadeEnabled) by any thread.
+    // A tile is heavy if its estimated cost is more than an equal share of all threads' work. Sub-tiles don't overlap, so primitives are still processed in order per sample
+    static constexpr bool       g_scTileSplittingEnabled = true;
+    static constexpr uint32_t   g_scMaxSubTilesPerTile = 4u;
+
+    static_assert(!g_scTileSplittingEnabled || g_scCostAwareTileSchedulingEnabled, "Tile splitting requires g_scCostAwareTileSchedulingEnabled");
+
+    // Max # draw iterations in flight, each of which has its own setup buffers, bins & coverage masks.
+    // Threads done with fragment shading of a draw iteration start geometry processing of the next one while others are still shading,
+    // a tile is still fragment-shaded in draw iteration order. 1 disables overlapping of draw iterations
+    static constexpr uint32_t   g_scMaxDrawIterationsInFlight = 2u;
+
+    // # locks serializing depth test & writes to 8x8 blocks fragment-shaded concurrently in order-independent drawcalls (see PipelineStateDesc),
+    // each of which covers all blocks whose index maps to it
+    static constexpr uint32_t   g_scNumBlockLocks = 1024u;
+
+    // Bounds of adaptive # spins (PAUSE) of a thread waiting on a WaitEvent before it's parked, instead of busy-waiting until its wait ends
+    static constexpr uint32_t   g_scWaitEventMinSpinCount = 64u;
+    static constexpr uint32_t   g_scWaitEventMaxSpinCount = 2048u;
+
+    // Toggle measurement of time it takes PipelineThreads to start working on a draw iteration (or tile resolve) after it's dispatched
+    static constexpr bool       g_scWakeUpStatsEnabled = false;
+
     // VS$ max entry size per-thread
     static constexpr uint32_t   g_scVertexShaderCacheSize = 32u;
 
@@ -19,8 +85,83 @@ namespace tyler
     // SSE -> 4 | AVX -> 8
     static constexpr uint32_t   g_scSIMDWidth = 4u;
 
-    // # samples per row / SIMD width
-    static constexpr uint32_t   g_scNumEdgeTestsPerRow = g_scPixelBlockSize / g_scSIMDWidth;
+    // Arrangement of samples that are processed together in SIMD lanes
+    enum class SampleLayout : uint32_t
+    {
+        ROW_1x4,    // 4 consecutive samples in a row
+        QUAD_2x2    // 2x2 quad of samples (enables screen-space derivatives in FS)
+    };
+
+    // Active SIMD sample layout
+    static constexpr SampleLayout g_scSampleLayout = SampleLayout::QUAD_2x2;
+
+    // Dimensions of a SIMD group of samples
+    static constexpr uint32_t   g_scSampleGroupWidth = (g_scSampleLayout == SampleLayout::QUAD_2x2) ? 2u : g_scSIMDWidth;
+    static constexpr uint32_t   g_scSampleGroupHeight = g_scSIMDWidth / g_scSampleGroupWidth;
+
+    // Offsets of samples within a SIMD group relative to the first sample, in lane order
+    struct SampleGroupOffsets
+    {
+        float   m_X[g_scSIMDWidth];
+        float   m_Y[g_scSIMDWidth];
+    };
+
+    static constexpr SampleGroupOffsets g_scSampleGroupOffsets = (g_scSampleLayout == SampleLayout::QUAD_2x2) ?
+        SampleGroupOffsets{ { 0.f, 1.f, 0.f, 1.f }, { 0.f, 0.f, 1.f, 1.f } } :
+        SampleGroupOffsets{ { 0.f, 1.f, 2.f, 3.f }, { 0.f, 0.f, 0.f, 0.f } };
+
+    // # SIMD sample groups per row of a block
+    static constexpr uint32_t   g_scNumEdgeTestsPerRow = g_scPixelBlockSize / g_scSampleGroupWidth;
+
+    // Pack live fragments of partially covered quads into full SIMD groups before invoking FS.
+    // Packed SIMD groups aren't 2x2 quads, so only FS that don't take derivatives are packed (see g_scShaderHintNoDerivatives)
+    static constexpr bool       g_scFragmentPackingEnabled = true;
+
+    // # samples & SIMD sample groups within a block
+    static constexpr uint32_t   g_scNumSamplesPerBlock = g_scPixelBlockSize * g_scPixelBlockSize;
+    static constexpr uint32_t   g_scNumSampleGroupsPerBlock = g_scNumSamplesPerBlock / g_scSIMDWidth;
+
+    // Arrangement of samples within tile buffers
+    enum class TileBufferLayout : uint32_t
+    {
+        LINEAR,         // Row-major within tile
+        BLOCK_SWIZZLED  // 8x8 blocks are contiguous in row-major order within tile, so are SIMD groups within block (Morton order for 2x2 quads)
+    };
+
+    // Active tile buffer layout, which is converted from/to linear framebuffer layout when tile buffers are loaded/resolved
+    static constexpr TileBufferLayout g_scTileBufferLayout = TileBufferLayout::BLOCK_SWIZZLED;
+
+    // All samples of a SIMD group can be accessed with a single aligned load/store
+    static constexpr bool       g_scIsSampleGroupContiguous = g_scTileBuffersEnabled && (g_scTileBufferLayout == TileBufferLayout::BLOCK_SWIZZLED);
+
+    // Offset of sample (x, y) within a block-swizzled 8x8 block
+    static constexpr uint32_t GetSwizzledBlockSampleOffset(uint32_t x, uint32_t y)
+    {
+        if (g_scSampleLayout == SampleLayout::QUAD_2x2)
+        {
+            // Interleave bits of x & y (Morton order), so that a 2x2 quad occupies 4 consecutive samples in lane order
+            return ((x & 1) | ((x & 2) << 1) | ((x & 4) << 2)) | (((y & 1) | ((y & 2) << 1) | ((y & 4) << 2)) << 1);
+        }
+        else
+        {
+            // Row-major, so that 1x4 rows of samples are consecutive already
+            return x + y * g_scPixelBlockSize;
+        }
+    }
+
+    // Offset of sample (x, y) of a tile within tile buffers of the tile (in # of samples)
+    static constexpr uint32_t GetTileSampleOffset(uint32_t x, uint32_t y, uint32_t tileSize)
+    {
+        if (g_scTileBufferLayout == TileBufferLayout::BLOCK_SWIZZLED)
+        {
+            const uint32_t blockIdx = (x / g_scPixelBlockSize) + (y / g_scPixelBlockSize) * (tileSize / g_scPixelBlockSize);
+            return blockIdx * g_scNumSamplesPerBlock + GetSwizzledBlockSampleOffset(x % g_scPixelBlockSize, y % g_scPixelBlockSize);
+        }
+        else
+        {
+            return x + y * tileSize;
+        }
+    }
 
     // Initial coverage masks buffer size
     static constexpr uint32_t   g_scRasterizerCoverageMaskBufferInitialSize = 4096u;
@@ -39,6 +180,15 @@ namespace tyler
         TILE_SIZE_MAX = 512u
     };
 
+    // Placement of pipeline threads on logical processors
+    enum class ThreadAffinity : uint32_t
+    {
+        NONE,       // Threads are scheduled on any logical processor by the OS
+        COMPACT,    // Threads are pinned to consecutive logical processors of a NUMA node before moving on to the next node
+        SCATTER,    // Threads are pinned to logical processors of NUMA nodes in turn, spreading them evenly across nodes
+        EXPLICIT    // Thread i is pinned to logical processor m_ThreadAffinityProcessors[i]
+    };
+
     struct RasterizerConfig
     {
         // List of all runtime/algorithmic parameters that can be configurad via command line
@@ -54,5 +204,13 @@ namespace tyler
         // Frame buffer tile size, multiples of 8x8 block(s) of pixels
         // @default: 64x64 == 8x8 blocks
         uint32_t    m_TileSize = TILE_SIZE_64x64;
+
+        // Pinning of pipeline threads to logical processors, so that they don't migrate across NUMA nodes
+        // and memory they first touch (bins, coverage masks, tile buffers etc.) is allocated on their own node
+        // @default: NONE
+        ThreadAffinity  m_ThreadAffinity = ThreadAffinity::NONE;
+
+        // Logical processors pipeline threads are pinned to with EXPLICIT affinity, reused in order if there are fewer than threads
+        std::vector<uint32_t> m_ThreadAffinityProcessors;
     };
 }
\ No newline at end of file
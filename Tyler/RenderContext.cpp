@@ -42,7 +42,18 @@ namespace tyler
 
     void RenderContext::BeginRenderPass(bool clearColor, const glm::vec4& colorValue, bool clearDepth, float depthValue)
     {
-        m_pRenderEngine->ClearRenderTargets(clearColor, colorValue, clearDepth, depthValue);
+        RenderPassDesc desc;
+        desc.m_ColorLoadOp = clearColor ? LoadOp::CLEAR : LoadOp::LOAD;
+        desc.m_ColorClearValue = colorValue;
+        desc.m_DepthLoadOp = clearDepth ? LoadOp::CLEAR : LoadOp::LOAD;
+        desc.m_DepthClearValue = depthValue;
+
+        m_pRenderEngine->BeginRenderPass(desc);
+    }
+
+    void RenderContext::BeginRenderPass(const RenderPassDesc& desc)
+    {
+        m_pRenderEngine->BeginRenderPass(desc);
     }
 
     void RenderContext::BindVertexBuffer(VertexBuffer* pVertexBuffer, uint32_t stride)
@@ -68,15 +79,82 @@ namespace tyler
 
     void RenderContext::BindShaders(VertexShader vertexShader, FragmentShader fragmentShader, const ShaderMetadata& metadata)
     {
-        // VS has to exist
+        BindShaders(vertexShader, fragmentShader, nullptr, metadata);
+    }
+
+    void RenderContext::BindShaders(VertexShader vertexShader, FragmentShader fragmentShader, BlockFragmentShader blockFragmentShader, const ShaderMetadata& metadata)
+    {
+        // VS has to exist, while FS entry points can both be NULL for depth-only rendering
         ASSERT(vertexShader != nullptr);
         ASSERT(metadata.m_NumVec4Attributes <= g_scMaxVertexAttributes);
         ASSERT(metadata.m_NumVec3Attributes <= g_scMaxVertexAttributes);
         ASSERT(metadata.m_NumVec2Attributes <= g_scMaxVertexAttributes);
+        // Subpass inputs are only fetched for FS invocations of SIMD groups
+        ASSERT(!(metadata.m_ShaderHints & g_scShaderHintSubpassInput) || ((blockFragmentShader == nullptr) && !(metadata.m_ShaderHints & g_scShaderHintConstantOutput)));
 
         m_pRenderEngine->m_VertexShader = vertexShader;
         m_pRenderEngine->m_FragmentShader = fragmentShader;
+        m_pRenderEngine->m_BlockFragmentShader = blockFragmentShader;
         m_pRenderEngine->m_ShaderMetadata = metadata;
+
+        if (metadata.m_ShaderHints & g_scShaderHintNoAttributes)
+        {
+            // FS won't read any attributes, so VS outputs are simply dropped
+            m_pRenderEngine->m_ShaderMetadata.m_NumVec4Attributes = 0u;
+            m_pRenderEngine->m_ShaderMetadata.m_NumVec3Attributes = 0u;
+            m_pRenderEngine->m_ShaderMetadata.m_NumVec2Attributes = 0u;
+        }
+        m_pRenderEngine->m_pShaderPipeline = m_pRenderEngine->m_pDynamicShaderPipeline;
+    }
+
+    void RenderContext::BindTileShader(TileShader tileShader)
+    {
+        // Tile shader works on tile buffers
+        ASSERT(g_scTileBuffersEnabled || (tileShader == nullptr));
+        m_pRenderEngine->m_TileShader = tileShader;
+    }
+
+    void RenderContext::BindPipeline(ShaderPipeline* pPipeline)
+    {
+        ASSERT(pPipeline != nullptr);
+        m_pRenderEngine->m_pShaderPipeline = pPipeline;
+    }
+
+    void RenderContext::DestroyPipeline(ShaderPipeline* pPipeline)
+    {
+        ASSERT(pPipeline != m_pRenderEngine->m_pDynamicShaderPipeline);
+
+        if (m_pRenderEngine->m_pShaderPipeline == pPipeline)
+        {
+            m_pRenderEngine->m_pShaderPipeline = nullptr;
+        }
+
+        delete pPipeline;
+    }
+
+    PipelineState* RenderContext::CreatePipelineState(const PipelineStateDesc& desc)
+    {
+        PipelineState* pPipelineState = new PipelineState();
+        RenderEngine::BakePipelineState(desc, pPipelineState);
+
+        return pPipelineState;
+    }
+
+    void RenderContext::BindPipelineState(const PipelineState* pPipelineState)
+    {
+        m_pRenderEngine->m_pPipelineState = (pPipelineState != nullptr) ? pPipelineState : &m_pRenderEngine->m_DefaultPipelineState;
+    }
+
+    void RenderContext::DestroyPipelineState(PipelineState* pPipelineState)
+    {
+        ASSERT(pPipelineState != nullptr);
+
+        if (m_pRenderEngine->m_pPipelineState == pPipelineState)
+        {
+            m_pRenderEngine->m_pPipelineState = &m_pRenderEngine->m_DefaultPipelineState;
+        }
+
+        delete pPipelineState;
     }
 
     void RenderContext::DrawIndexed(uint32_t indexCount, uint32_t vertexOffset)
@@ -95,8 +173,31 @@ namespace tyler
         m_pRenderEngine->Draw(vertexCount / 3, vertexOffset, false /*isIndexed*/);
     }
 
-    void RenderContext::EndRenderPass()
+    void RenderContext::EndRenderPass(bool resolveFastClears)
+    {
+        if constexpr (g_scTileBuffersEnabled)
+        {
+            // Write rendered tiles back to bound framebuffer, except for attachments with DONT_CARE store action
+            m_pRenderEngine->ResolveTileBuffers(resolveFastClears ? g_scFastClearAll : 0u);
+        }
+    }
+
+    ThreadWakeUpStats RenderContext::GetThreadWakeUpStats() const
+    {
+        ThreadWakeUpStats stats;
+        m_pRenderEngine->GetThreadWakeUpStats(&stats);
+
+        return stats;
+    }
+
+    void RenderContext::ResetThreadWakeUpStats()
+    {
+        m_pRenderEngine->ResetThreadWakeUpStats();
+    }
+
+    uint8_t RenderContext::GetFastClearFlags(uint32_t x, uint32_t y) const
     {
-        //TODO
+        ASSERT((x < m_pRenderEngine->m_Framebuffer.m_Width) && (y < m_pRenderEngine->m_Framebuffer.m_Height));
+        return m_pRenderEngine->GetFastClearFlags(x, y);
     }
 }
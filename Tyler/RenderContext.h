@@ -2,6 +2,7 @@
 
 #include "RasterizerConfig.h"
 #include "RenderState.h"
+#include "ShaderPipeline.h"
 
 namespace tyler
 {
@@ -20,9 +21,13 @@ namespace tyler
         // Bind active color/depth buffers to be used in subsequent render pass
         void BindFramebuffer(Framebuffer* pFramebuffer);
 
-        // Clear render targets, if requested
+        // Clear render targets, if requested, otherwise preserve their contents (LOAD/CLEAR load actions & STORE store actions)
         void BeginRenderPass(bool clearColor, const glm::vec4& colorValue, bool clearDepth, float depthValue);
 
+        // Begin render pass with given load/store actions of color & depth attachments
+        // Depth buffer needn't be bound if depth isn't loaded and DONT_CARE is its store action, since it then only lives in tile buffers
+        void BeginRenderPass(const RenderPassDesc& desc);
+
         // Set active vertex buffer and input stride for next drawcall
         void BindVertexBuffer(VertexBuffer* pVertexBuffer, uint32_t stride);
 
@@ -32,14 +37,51 @@ namespace tyler
         // Bind pointer to constant buffer to be passed to VS/FS
         void BindConstantBuffer(ConstantBuffer* pConstantBuffer);
 
-        // Bind shaders and shaders metada to be used
+        // Bind shaders and shaders metada to be used (fragmentShader may be NULL for depth-only rendering)
         void BindShaders(VertexShader vertexShader, FragmentShader fragmentShader, const ShaderMetadata& metadata);
 
+        // Same as above with an additional block FS that will shade fully covered blocks/tiles (fragmentShader may be NULL)
+        void BindShaders(VertexShader vertexShader, FragmentShader fragmentShader, BlockFragmentShader blockFragmentShader, const ShaderMetadata& metadata);
+
+        // Bind tile shader to be invoked on each tile when render pass ends (NULL unbinds), requires g_scTileBuffersEnabled
+        void BindTileShader(TileShader tileShader);
+
+        // Create a pipeline specialized for VS/FS functors, AttributeLayout and g_scShaderHint* flags, whose shaders are inlined into pipeline stages
+        template<typename VS, typename FS, typename AttribLayout, uint8_t ShaderHints = 0u>
+        ShaderPipeline* CreatePipeline()
+        {
+            return new TypedShaderPipeline<VS, FS, AttribLayout, ShaderHints>();
+        }
+
+        // Bind a pipeline created via CreatePipeline() to be used instead of shaders bound via BindShaders()
+        void BindPipeline(ShaderPipeline* pPipeline);
+
+        // Free a pipeline created via CreatePipeline()
+        void DestroyPipeline(ShaderPipeline* pPipeline);
+
+        // Create immutable fixed-function state (depth/color writes, culling) to be bound via BindPipelineState()
+        PipelineState* CreatePipelineState(const PipelineStateDesc& desc);
+
+        // Bind pipeline state to be used by subsequent drawcalls, NULL restores default state
+        void BindPipelineState(const PipelineState* pPipelineState);
+
+        // Free a pipeline state created via CreatePipelineState()
+        void DestroyPipelineState(PipelineState* pPipelineState);
+
         // Drawcalls
         void DrawIndexed(uint32_t indexCount, uint32_t vertexOffset);
         void Draw(uint32_t vertexCount, uint32_t vertexOffset);
 
-        void EndRenderPass();
+        // Framebuffer contents are only guaranteed to be up to date after render pass ends
+        // If resolveFastClears is false, clear values of tiles that weren't drawn to are not written to framebuffer, see GetFastClearFlags()
+        void EndRenderPass(bool resolveFastClears = true);
+
+        // g_scFastClear* flags of RTs whose framebuffer contents at given pixel are to be taken as the clear value, valid until next render pass begins or RTs are rebound
+        uint8_t GetFastClearFlags(uint32_t x, uint32_t y) const;
+
+        // Wake-up latency of PipelineThreads accumulated since last reset (only measured if g_scWakeUpStatsEnabled), which mustn't be queried while drawing
+        ThreadWakeUpStats GetThreadWakeUpStats() const;
+        void ResetThreadWakeUpStats();
 
         // Shutdown @RenderEngine/subsystems and free all dynamically alloc'd memory
         void Destroy();
@@ -1,34 +1,56 @@
 #include "RenderEngine.h"
 
 #include "PipelineThread.h"
+#include "ShaderPipeline.h"
+#include "ThreadAffinity.h"
 
 namespace tyler
 {
     RenderEngine::RenderEngine(const RasterizerConfig& renderConfig)
         :
         m_RenderConfig(renderConfig),
-        m_DrawcallSetupComplete(false)
+        m_NumDispatchedIterations(0u),
+        m_NextTileToResolve(0u)
     {
-        // Allocate triangle setup data big enough to hold all possible in-flight primitives
-        m_SetupBuffers.m_pEdgeCoefficients = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 3 /* 3 vertices */];
-        m_SetupBuffers.m_pInterpolatedZValues = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize];
+        for (DrawIteration& drawIteration : m_DrawIterations)
+        {
+            TriangleSetupBuffers& setupBuffers = drawIteration.m_SetupBuffers;
+
+            // Allocate triangle setup data big enough to hold all possible in-flight primitives
+            setupBuffers.m_pEdgeCoefficients = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 3 /* 3 vertices */];
+            setupBuffers.m_pDepthPlaneCoefficients = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize];
 
-        // Allocate memory for bounding boxed to be cached after Binning
-        m_SetupBuffers.m_pPrimBBoxes = new Rect2D[m_RenderConfig.m_MaxDrawIterationSize];
+            // Allocate memory for bounding boxed to be cached after Binning
+            setupBuffers.m_pPrimBBoxes = new Rect2D[m_RenderConfig.m_MaxDrawIterationSize];
 
-        // Allocate memory for interpolation related data
-        for (uint32_t i = 0; i < g_scMaxVertexAttributes; i++)
+            // Allocate memory for interpolation related data
+            for (uint32_t i = 0; i < g_scMaxVertexAttributes; i++)
+            {
+                setupBuffers.m_Attribute4Deltas[i] = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 4 /*xyzw*/];
+                setupBuffers.m_Attribute3Deltas[i] = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 3 /*xyz*/];
+                setupBuffers.m_Attribute2Deltas[i] = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 2 /*xy*/];
+            }
+        }
+
+        for (std::atomic_flag& blockLock : m_BlockLocks)
         {
-            m_SetupBuffers.m_Attribute4Deltas[i] = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 4 /*xyzw*/];
-            m_SetupBuffers.m_Attribute3Deltas[i] = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 3 /*xyz*/];
-            m_SetupBuffers.m_Attribute2Deltas[i] = new glm::vec3[m_RenderConfig.m_MaxDrawIterationSize * 2 /*xy*/];
+            blockLock.clear(std::memory_order_relaxed);
         }
 
+        // Pipeline invoking shaders bound as function pointers
+        m_pDynamicShaderPipeline = new ShaderPipelineImpl<DynamicShaders>();
+
+        BakePipelineState(PipelineStateDesc{}, &m_DefaultPipelineState);
+        m_pPipelineState = &m_DefaultPipelineState;
+
+        // Logical processors worker threads are pinned to, if any
+        const std::vector<uint32_t> threadProcessors = ComputePipelineThreadProcessors(m_RenderConfig);
+
         // Create PipelineThreads that will spawn their own worker thread to implement the pipeline stages in parallel
         m_PipelineThreads.resize(m_RenderConfig.m_NumPipelineThreads);
         for (uint32_t idx = 0; idx < m_RenderConfig.m_NumPipelineThreads; idx++)
         {
-            PipelineThread* pThread = new PipelineThread(this, idx);
+            PipelineThread* pThread = new PipelineThread(this, idx, threadProcessors.empty() ? g_scInvalidProcessorIndex : threadProcessors[idx]);
             m_PipelineThreads[idx] = pThread;
         }
     }
@@ -42,80 +64,118 @@ namespace tyler
             delete pThread;
         }
 
-        for (auto& perTileCoverageMask : m_CoverageMasks)
+        delete m_pDynamicShaderPipeline;
+
+        for (DrawIteration& drawIteration : m_DrawIterations)
         {
-            for (auto& perThreadCoverageMasks : perTileCoverageMask)
+            for (auto& perTileCoverageMask : drawIteration.m_CoverageMasks)
             {
-                delete perThreadCoverageMasks;
+                for (auto& perThreadCoverageMasks : perTileCoverageMask)
+                {
+                    delete perThreadCoverageMasks;
+                }
             }
-        }
 
-        // Triangle setup buffers
-        delete[] m_SetupBuffers.m_pEdgeCoefficients;
-        delete[] m_SetupBuffers.m_pPrimBBoxes;
+            // Triangle setup buffers
+            TriangleSetupBuffers& setupBuffers = drawIteration.m_SetupBuffers;
 
-        for (uint32_t i = 0; i < g_scMaxVertexAttributes; i++)
-        {
-            delete[] m_SetupBuffers.m_Attribute4Deltas[i];
-            delete[] m_SetupBuffers.m_Attribute3Deltas[i];
-            delete[] m_SetupBuffers.m_Attribute2Deltas[i];
+            delete[] setupBuffers.m_pEdgeCoefficients;
+            delete[] setupBuffers.m_pPrimBBoxes;
+
+            for (uint32_t i = 0; i < g_scMaxVertexAttributes; i++)
+            {
+                delete[] setupBuffers.m_Attribute4Deltas[i];
+                delete[] setupBuffers.m_Attribute3Deltas[i];
+                delete[] setupBuffers.m_Attribute2Deltas[i];
+            }
+
+            delete[] setupBuffers.m_pDepthPlaneCoefficients;
         }
 
-        delete[] m_SetupBuffers.m_pInterpolatedZValues;
+        _mm_free(m_pTileColorBuffers);
+        _mm_free(m_pTileDepthBuffers);
     }
 
-    void RenderEngine::ClearRenderTargets(bool clearColor, const glm::vec4& colorValue, bool clearDepth, float depthValue)
+    void RenderEngine::BeginRenderPass(const RenderPassDesc& desc)
     {
+        const bool clearColor = (desc.m_ColorLoadOp == LoadOp::CLEAR);
+        const bool clearDepth = (desc.m_DepthLoadOp == LoadOp::CLEAR);
+
+        const uint8_t fastClearFlags = static_cast<uint8_t>((clearColor ? g_scFastClearColor : 0u) | (clearDepth ? g_scFastClearDepth : 0u));
+        const uint8_t discardFlags = static_cast<uint8_t>(
+            ((desc.m_ColorLoadOp == LoadOp::DONT_CARE) ? g_scFastClearColor : 0u) | ((desc.m_DepthLoadOp == LoadOp::DONT_CARE) ? g_scFastClearDepth : 0u));
+
+        if constexpr (g_scTileBuffersEnabled)
+        {
+            // Previous render pass may not have been ended explicitly, though its fast clears of RTs cleared or discarded now needn't be written
+            ResolveTileBuffers(static_cast<uint8_t>(g_scFastClearAll & ~(fastClearFlags | discardFlags)));
+        }
+
+        m_RenderPassDesc = desc;
+        m_IsRenderPassActive = true;
+
         ASSERT(!clearColor || (m_Framebuffer.m_pColorBuffer != nullptr));
-        ASSERT(!clearDepth || (m_Framebuffer.m_pDepthBuffer != nullptr));
+        ASSERT(!clearDepth || (m_Framebuffer.m_pDepthBuffer != nullptr) || IsDepthTransient());
 
-        if (clearColor)
+        const glm::vec4& colorValue = desc.m_ColorClearValue;
+        const glm::uvec4 color =
         {
-            const glm::uvec4 color =
-            {
-                static_cast<uint8_t>(colorValue.x * 255.f),
-                static_cast<uint8_t>(colorValue.y * 255.f),
-                static_cast<uint8_t>(colorValue.z * 255.f),
-                static_cast<uint8_t>(colorValue.w * 255.f),
-            };
+            static_cast<uint8_t>(colorValue.x * 255.f),
+            static_cast<uint8_t>(colorValue.y * 255.f),
+            static_cast<uint8_t>(colorValue.z * 255.f),
+            static_cast<uint8_t>(colorValue.w * 255.f),
+        };
 
-            const uint32_t fbSize = m_Framebuffer.m_Width * m_Framebuffer.m_Height * 4 /*R8G8B8A8_UNORM*/;
+        // Only record clear values and flag all tiles, clears are applied when tile buffers are loaded or resolved so that framebuffer is written only once
+        m_ColorClearValue = color.x | (color.y << 8) | (color.z << 16) | (color.w << 24);
+        m_DepthClearValue = desc.m_DepthClearValue;
 
-            for (uint32_t i = 0; i < fbSize; i += 4)
-            {
-                // Surface format == R8G8B8A8_UNORM
+        std::fill(m_FastClearFlags.begin(), m_FastClearFlags.end(), fastClearFlags);
 
-                m_Framebuffer.m_pColorBuffer[i + 0] = color.x;
-                m_Framebuffer.m_pColorBuffer[i + 1] = color.y;
-                m_Framebuffer.m_pColorBuffer[i + 2] = color.z;
-                m_Framebuffer.m_pColorBuffer[i + 3] = color.w;
-            }
+        if constexpr (!g_scTileBuffersEnabled)
+        {
+            // Fragment stage works on framebuffer directly, so fill it right away in parallel
+            ResolveTileBuffers();
         }
 
         if (clearDepth)
         {
-            const uint32_t fbSize = m_Framebuffer.m_Width * m_Framebuffer.m_Height * 1 /*D32_FLOAT*/;
-
-            for (uint32_t i = 0; i < fbSize; i++)
-            {
-                m_Framebuffer.m_pDepthBuffer[i] = depthValue;
-            }
+            // All blocks now have the same max depth
+            std::fill(m_HiZBuffer.begin(), m_HiZBuffer.end(), desc.m_DepthClearValue);
+        }
+        else
+        {
+            // Depth buffer contents may have been modified outside of the engine (or be undefined), so HiZ must not reject anything
+            std::fill(m_HiZBuffer.begin(), m_HiZBuffer.end(), FLT_MAX);
         }
     }
 
     void RenderEngine::SetRenderTargets(Framebuffer* pFramebuffer)
     {
         //TODO: Check active framebuffer for any meaningful change (e.g. RT resolution) before allocating RT-dependent data!
-        //TODO: NULL RT for color/depth for color-only or depth-only rendering?!
+
+        if constexpr (g_scTileBuffersEnabled)
+        {
+            // Tile buffers still hold contents of previously bound RTs
+            ResolveTileBuffers();
+        }
+
+        if (pFramebuffer->m_pDepthBuffer != m_Framebuffer.m_pDepthBuffer)
+        {
+            // HiZ values of previous depth buffer don't apply to the new one
+            std::fill(m_HiZBuffer.begin(), m_HiZBuffer.end(), FLT_MAX);
+        }
+
+        // RTs can change without resolution changing (e.g. shadow map cascades), NULL color RT means depth-only rendering
+        m_Framebuffer.m_pColorBuffer = pFramebuffer->m_pColorBuffer;
+        m_Framebuffer.m_pDepthBuffer = pFramebuffer->m_pDepthBuffer;
 
         if ((pFramebuffer->m_Width != m_Framebuffer.m_Width) ||
             (pFramebuffer->m_Height != m_Framebuffer.m_Height))
         {
-            // Set active render area and RTs
+            // Set active render area
             m_Framebuffer.m_Width = pFramebuffer->m_Width;
             m_Framebuffer.m_Height = pFramebuffer->m_Height;
-            m_Framebuffer.m_pColorBuffer = pFramebuffer->m_pColorBuffer;
-            m_Framebuffer.m_pDepthBuffer = pFramebuffer->m_pDepthBuffer;
 
             ASSERT((m_Framebuffer.m_Width > 0u) && (m_Framebuffer.m_Height > 0u));
 
@@ -142,7 +202,8 @@ namespace tyler
                     Tile tile;
                     tile.m_PosX = static_cast<float>(glm::min(m_Framebuffer.m_Width, x * m_RenderConfig.m_TileSize));
                     tile.m_PosY = static_cast<float>(glm::min(m_Framebuffer.m_Height, y * m_RenderConfig.m_TileSize));
-                    // Tile::m_IsTileQueued flag will be cleared pre-draw iteration
+                    tile.m_DispatchOrder = ComputeTileDispatchOrder(x, y);
+                    // TileIterationState flags will be cleared pre-draw iteration
 
                     m_TileList[GetGlobalTileIndex(x, y)] = tile;
                 }
@@ -150,36 +211,398 @@ namespace tyler
 
             //TODO: Only resize vector when necessary!!!
 
-            // Configure array of bins based on RT and tile size
-            // m_BinList[TILE_COUNT][THREAD_COUNT][PRIM_COUNT]
-            m_BinList.resize(totalTileCount);
-            for (uint32_t i = 0; i < totalTileCount; i++)
+            for (DrawIteration& drawIteration : m_DrawIterations)
             {
-                m_BinList[i].resize(m_RenderConfig.m_NumPipelineThreads);
+                // Configure array of bins based on RT and tile size
+                // m_BinList[TILE_COUNT][THREAD_COUNT][PRIM_COUNT]
+                drawIteration.m_BinList.assign(totalTileCount, std::vector<std::vector<uint32_t>>(m_RenderConfig.m_NumPipelineThreads));
 
-                for (uint32_t j = 0; j < m_RenderConfig.m_NumPipelineThreads; j++)
+                // Configure array of coverage masks buffer, unless coverage masks never leave the thread rasterizing them
+                //m_CoverageMasks[TILE_COUNT][THREAD_COUNT]
+                if constexpr (!g_scFusedRasterShadeEnabled)
                 {
-                    // Only reserve the memory for per-thread primitive indices!
-                    m_BinList[i][j].reserve(m_RenderConfig.m_MaxDrawIterationSize / m_RenderConfig.m_NumPipelineThreads);
+                    for (auto& perTileCoverageMask : drawIteration.m_CoverageMasks)
+                    {
+                        for (auto& perThreadCoverageMasks : perTileCoverageMask)
+                        {
+                            delete perThreadCoverageMasks;
+                        }
+                    }
+
+                    drawIteration.m_CoverageMasks.assign(totalTileCount, std::vector<CoverageMaskBuffer*>(m_RenderConfig.m_NumPipelineThreads, nullptr));
                 }
+
+                // Each thread reserves its own bins and allocates its own coverage mask buffers when it starts processing the draw iteration
+                drawIteration.m_IsThreadTileStorageAllocated.assign(m_RenderConfig.m_NumPipelineThreads, 0u);
+
+                // Tiles aren't queued in any draw iteration yet
+                drawIteration.m_TileStates.clear();
+                drawIteration.m_TileStates.resize(totalTileCount);
+
+                // Allocate rasterizer queue sized for total work item count of tiles + overrun space (when any thread will reach the end of the queue memory)
+                const uint32_t maxNumWorkItemsPerTile = glm::max(m_RenderConfig.m_NumPipelineThreads, g_scTileSplittingEnabled ? g_scMaxSubTilesPerTile : 1u);
+                drawIteration.m_RasterizerQueue.AllocateBackingMemory(totalTileCount * maxNumWorkItemsPerTile + m_RenderConfig.m_NumPipelineThreads);
+            }
+
+            // Allocate per-block max depth values, nothing can be rejected until depth buffer is cleared
+            m_NumBlockPerRow = (m_Framebuffer.m_Width + g_scPixelBlockSize - 1) / g_scPixelBlockSize;
+            uint32_t numBlockPerColumn = (m_Framebuffer.m_Height + g_scPixelBlockSize - 1) / g_scPixelBlockSize;
+
+            m_HiZBuffer.assign(m_NumBlockPerRow * numBlockPerColumn, FLT_MAX);
+
+            // Tile sizes are powers of two, so that tile buffer addressing only needs shifts and masks
+            ASSERT((m_RenderConfig.m_TileSize & (m_RenderConfig.m_TileSize - 1)) == 0);
+            // Tiles are made of whole 8x8 blocks
+            ASSERT(m_RenderConfig.m_TileSize >= g_scPixelBlockSize);
+
+            m_TileSizeLog2 = 0u;
+            while ((1u << m_TileSizeLog2) < m_RenderConfig.m_TileSize)
+            {
+                m_TileSizeLog2++;
             }
 
-            // Configure array of coverage masks buffer
-            //m_CoverageMasks[TILE_COUNT][THREAD_COUNT]
-            m_CoverageMasks.resize(totalTileCount);
-            for (uint32_t i = 0; i < totalTileCount; i++)
+            // Allocate tile buffers of all tiles, none of which holds any contents yet (i.e. as large as the RTs, see g_scTileBuffersEnabled)
+            if constexpr (g_scTileBuffersEnabled)
+            {
+                const size_t numTileSamples = static_cast<size_t>(totalTileCount) * m_RenderConfig.m_TileSize * m_RenderConfig.m_TileSize;
+
+                _mm_free(m_pTileColorBuffers);
+                _mm_free(m_pTileDepthBuffers);
+
+                m_pTileColorBuffers = static_cast<uint8_t*>(_mm_malloc(numTileSamples * 4 /*R8G8B8A8_UNORM*/, 64));
+                m_pTileDepthBuffers = static_cast<float*>(_mm_malloc(numTileSamples * sizeof(float) /*D32_FLOAT*/, 64));
+            }
+
+            // Neither tile buffers nor fast clears hold any contents of the new RTs yet
+            m_IsTileBufferLoaded.assign(totalTileCount, 0u);
+            m_FastClearFlags.assign(totalTileCount, 0u);
+        }
+    }
+
+    // Copy tile-sized region of 32-bit values from framebuffer to tile buffer in the layout of tile buffers
+    static void LoadTileRegion(uint32_t* pTile, const uint32_t* pSrc, uint32_t srcPitch, uint32_t tileSize, uint32_t numCols, uint32_t numRows)
+    {
+        if constexpr (g_scTileBufferLayout == TileBufferLayout::BLOCK_SWIZZLED)
+        {
+            if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
             {
-                m_CoverageMasks[i].resize(m_RenderConfig.m_NumPipelineThreads);
+                if (((numCols % g_scPixelBlockSize) == 0) && ((numRows % g_scPixelBlockSize) == 0))
+                {
+                    // Each 4 samples of two consecutive rows make two horizontally adjacent quads
+                    for (uint32_t y = 0; y < numRows; y += 2)
+                    {
+                        for (uint32_t x = 0; x < numCols; x += 4)
+                        {
+                            __m128i sseRow0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x + y * srcPitch));
+                            __m128i sseRow1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + x + (y + 1) * srcPitch));
+
+                            __m128i* pQuads = reinterpret_cast<__m128i*>(pTile + GetTileSampleOffset(x, y, tileSize));
+                            _mm_store_si128(pQuads, _mm_unpacklo_epi64(sseRow0, sseRow1));
+                            _mm_store_si128(pQuads + 1, _mm_unpackhi_epi64(sseRow0, sseRow1));
+                        }
+                    }
+
+                    return;
+                }
+            }
 
-                for (uint32_t j = 0; j < m_RenderConfig.m_NumPipelineThreads; j++)
+            for (uint32_t y = 0; y < numRows; y++)
+            {
+                for (uint32_t x = 0; x < numCols; x++)
                 {
-                    CoverageMaskBuffer* pBuffer = new CoverageMaskBuffer();
-                    m_CoverageMasks[i][j] = pBuffer;
+                    pTile[GetTileSampleOffset(x, y, tileSize)] = pSrc[x + y * srcPitch];
                 }
             }
+        }
+        else
+        {
+            for (uint32_t row = 0; row < numRows; row++)
+            {
+                memcpy(pTile + row * tileSize, pSrc + row * srcPitch, numCols * sizeof(uint32_t));
+            }
+        }
+    }
+
+    void RenderEngine::LoadTileBuffers(uint32_t tileIdx)
+    {
+        ASSERT(tileIdx < m_IsTileBufferLoaded.size());
+
+        if (m_IsTileBufferLoaded[tileIdx])
+        {
+            return;
+        }
+
+        const uint32_t tileSize = m_RenderConfig.m_TileSize;
+        const uint32_t tileSampleOffset = tileIdx << (2 * m_TileSizeLog2);
+
+        uint32_t* pTileColor = reinterpret_cast<uint32_t*>(m_pTileColorBuffers) + tileSampleOffset;
+        float* pTileDepth = m_pTileDepthBuffers + tileSampleOffset;
+
+        // Framebuffer region covered by the tile
+        const uint32_t tilePosX = static_cast<uint32_t>(m_TileList[tileIdx].m_PosX);
+        const uint32_t tilePosY = static_cast<uint32_t>(m_TileList[tileIdx].m_PosY);
+        const uint32_t numCols = glm::min(tileSize, m_Framebuffer.m_Width - tilePosX);
+        const uint32_t numRows = glm::min(tileSize, m_Framebuffer.m_Height - tilePosY);
+
+        const uint8_t fastClearFlags = m_FastClearFlags[tileIdx];
+
+        if (fastClearFlags & g_scFastClearColor)
+        {
+            std::fill(pTileColor, pTileColor + tileSize * tileSize, m_ColorClearValue);
+        }
+        else if ((m_RenderPassDesc.m_ColorLoadOp != LoadOp::DONT_CARE) && (m_Framebuffer.m_pColorBuffer != nullptr))
+        {
+            const uint32_t* pColor = reinterpret_cast<const uint32_t*>(m_Framebuffer.m_pColorBuffer) + tilePosX + tilePosY * m_Framebuffer.m_Width;
+            LoadTileRegion(pTileColor, pColor, m_Framebuffer.m_Width, tileSize, numCols, numRows);
+        }
+
+        if (fastClearFlags & g_scFastClearDepth)
+        {
+            std::fill(pTileDepth, pTileDepth + tileSize * tileSize, m_DepthClearValue);
+        }
+        else if (m_RenderPassDesc.m_DepthLoadOp != LoadOp::DONT_CARE)
+        {
+            const uint32_t* pDepth = reinterpret_cast<const uint32_t*>(m_Framebuffer.m_pDepthBuffer) + tilePosX + tilePosY * m_Framebuffer.m_Width;
+            LoadTileRegion(reinterpret_cast<uint32_t*>(pTileDepth), pDepth, m_Framebuffer.m_Width, tileSize, numCols, numRows);
+        }
+
+        // Tile buffers hold clear values now
+        m_FastClearFlags[tileIdx] = 0u;
+        m_IsTileBufferLoaded[tileIdx] = 1u;
+    }
+
+    // Copy a row of 32-bit values to framebuffer, bypassing caches where possible since framebuffer won't be read again in the render pass
+    static void StreamFramebufferRow(uint32_t* pDst, const uint32_t* pSrc, uint32_t count)
+    {
+        // Streaming stores have to be 16-byte aligned
+        uint32_t i = 0;
+        for (; (i < count) && ((reinterpret_cast<uintptr_t>(pDst + i) % 16) != 0); i++)
+        {
+            pDst[i] = pSrc[i];
+        }
+
+        for (; (i + 4) <= count; i += 4)
+        {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i)));
+        }
+
+        for (; i < count; i++)
+        {
+            pDst[i] = pSrc[i];
+        }
+    }
+
+    static void FillFramebufferRow(uint32_t* pDst, uint32_t value, uint32_t count)
+    {
+        const __m128i sseValue = _mm_set1_epi32(static_cast<int32_t>(value));
 
-            // Allocate rasterizer queue sized for total tile count + overrun space (when any thread will reach the end of the queue memory)
-            m_RasterizerQueue.AllocateBackingMemory(totalTileCount + m_RenderConfig.m_NumPipelineThreads);
+        uint32_t i = 0;
+        for (; (i < count) && ((reinterpret_cast<uintptr_t>(pDst + i) % 16) != 0); i++)
+        {
+            pDst[i] = value;
+        }
+
+        for (; (i + 4) <= count; i += 4)
+        {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(pDst + i), sseValue);
+        }
+
+        for (; i < count; i++)
+        {
+            pDst[i] = value;
+        }
+    }
+
+    // Copy tile-sized region of 32-bit values in the layout of tile buffers from tile buffer back to framebuffer
+    static void ResolveTileRegion(uint32_t* pDst, uint32_t dstPitch, const uint32_t* pTile, uint32_t tileSize, uint32_t numCols, uint32_t numRows)
+    {
+        if constexpr (g_scTileBufferLayout == TileBufferLayout::BLOCK_SWIZZLED)
+        {
+            if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
+            {
+                if (((numCols % g_scPixelBlockSize) == 0) && ((numRows % g_scPixelBlockSize) == 0))
+                {
+                    // Rows are written across blocks so that streaming stores fill whole cache lines
+                    for (uint32_t y = 0; y < numRows; y += 2)
+                    {
+                        uint32_t* pRow0 = pDst + y * dstPitch;
+                        uint32_t* pRow1 = pDst + (y + 1) * dstPitch;
+
+                        // Streaming stores have to be 16-byte aligned
+                        const bool isRow0Aligned = (reinterpret_cast<uintptr_t>(pRow0) % 16) == 0;
+                        const bool isRow1Aligned = (reinterpret_cast<uintptr_t>(pRow1) % 16) == 0;
+
+                        for (uint32_t x = 0; x < numCols; x += 4)
+                        {
+                            const __m128i* pQuads = reinterpret_cast<const __m128i*>(pTile + GetTileSampleOffset(x, y, tileSize));
+                            __m128i sseQuad0 = _mm_load_si128(pQuads);
+                            __m128i sseQuad1 = _mm_load_si128(pQuads + 1);
+
+                            __m128i sseRow0 = _mm_unpacklo_epi64(sseQuad0, sseQuad1);
+                            __m128i sseRow1 = _mm_unpackhi_epi64(sseQuad0, sseQuad1);
+
+                            if (isRow0Aligned)
+                            {
+                                _mm_stream_si128(reinterpret_cast<__m128i*>(pRow0 + x), sseRow0);
+                            }
+                            else
+                            {
+                                _mm_storeu_si128(reinterpret_cast<__m128i*>(pRow0 + x), sseRow0);
+                            }
+
+                            if (isRow1Aligned)
+                            {
+                                _mm_stream_si128(reinterpret_cast<__m128i*>(pRow1 + x), sseRow1);
+                            }
+                            else
+                            {
+                                _mm_storeu_si128(reinterpret_cast<__m128i*>(pRow1 + x), sseRow1);
+                            }
+                        }
+                    }
+
+                    return;
+                }
+            }
+
+            for (uint32_t y = 0; y < numRows; y++)
+            {
+                for (uint32_t x = 0; x < numCols; x++)
+                {
+                    pDst[x + y * dstPitch] = pTile[GetTileSampleOffset(x, y, tileSize)];
+                }
+            }
+        }
+        else
+        {
+            for (uint32_t row = 0; row < numRows; row++)
+            {
+                StreamFramebufferRow(pDst + row * dstPitch, pTile + row * tileSize, numCols);
+            }
+        }
+    }
+
+    void RenderEngine::ResolveTileBuffers(uint8_t fastClearsToResolve)
+    {
+        if (m_TileList.empty())
+        {
+            // No RTs bound yet
+            return;
+        }
+
+        m_FastClearsToResolve = fastClearsToResolve;
+        m_IsTileShaderEnabled = g_scTileBuffersEnabled && m_IsRenderPassActive && (m_TileShader != nullptr);
+        m_NextTileToResolve.store(0u, std::memory_order_relaxed);
+
+        if constexpr (g_scWakeUpStatsEnabled)
+        {
+            m_DispatchTime = std::chrono::steady_clock::now();
+        }
+
+        // Tiles are resolved independently, so have all PipelineThreads fetch and resolve them
+        for (PipelineThread* pThread : m_PipelineThreads)
+        {
+            ASSERT((pThread != nullptr) && (pThread->m_CurrentState.load() == ThreadStatus::IDLE));
+            pThread->m_CurrentState.store(ThreadStatus::TILE_RESOLVE, std::memory_order_release);
+            pThread->m_WakeUpEvent.NotifyAll();
+        }
+
+        WaitForPipelineThreadsToCompleteResolve();
+
+        m_IsRenderPassActive = false;
+    }
+
+    void RenderEngine::ResolveTile(uint32_t tileIdx, uint8_t fastClearsToResolve)
+    {
+        if (m_IsTileShaderEnabled)
+        {
+            // Tile shader sees all tiles, so tiles that weren't drawn to are brought into tile buffers as well
+            LoadTileBuffers(tileIdx);
+
+            const uint32_t tilePosX = static_cast<uint32_t>(m_TileList[tileIdx].m_PosX);
+            const uint32_t tilePosY = static_cast<uint32_t>(m_TileList[tileIdx].m_PosY);
+            const uint32_t tileSampleOffset = tileIdx << (2 * m_TileSizeLog2);
+
+            TileShaderInput tileShaderInput;
+            tileShaderInput.m_pColor = m_pTileColorBuffers + 4 * tileSampleOffset;
+            tileShaderInput.m_pDepth = m_pTileDepthBuffers + tileSampleOffset;
+            tileShaderInput.m_TileSize = m_RenderConfig.m_TileSize;
+            tileShaderInput.m_PosX = tilePosX;
+            tileShaderInput.m_PosY = tilePosY;
+            tileShaderInput.m_Width = glm::min(m_RenderConfig.m_TileSize, m_Framebuffer.m_Width - tilePosX);
+            tileShaderInput.m_Height = glm::min(m_RenderConfig.m_TileSize, m_Framebuffer.m_Height - tilePosY);
+
+            // Tile buffers are still in cache when written to framebuffer right after
+            m_TileShader(&tileShaderInput, m_pConstantBuffer);
+        }
+
+        const bool isTileBufferLoaded = (m_IsTileBufferLoaded[tileIdx] != 0u);
+
+        // Contents of attachments with DONT_CARE store action are undefined after render pass, so neither they nor their fast clears are written
+        // Without tile buffers, fragment stage works on framebuffer directly and store actions don't apply
+        const bool isColorDiscarded = g_scTileBuffersEnabled && (m_RenderPassDesc.m_ColorStoreOp == StoreOp::DONT_CARE);
+        const bool isDepthDiscarded = g_scTileBuffersEnabled && (m_RenderPassDesc.m_DepthStoreOp == StoreOp::DONT_CARE);
+        const uint8_t discardFlags = static_cast<uint8_t>((isColorDiscarded ? g_scFastClearColor : 0u) | (isDepthDiscarded ? g_scFastClearDepth : 0u));
+
+        m_FastClearFlags[tileIdx] &= static_cast<uint8_t>(~discardFlags);
+        const uint8_t fastClearFlags = m_FastClearFlags[tileIdx] & fastClearsToResolve;
+
+        // Tiles that weren't touched in render pass only need fast clears to be applied, if any
+        if (!isTileBufferLoaded && (fastClearFlags == 0u))
+        {
+            return;
+        }
+
+        const uint32_t tileSize = m_RenderConfig.m_TileSize;
+
+        uint32_t* pColor = isColorDiscarded ? nullptr : reinterpret_cast<uint32_t*>(m_Framebuffer.m_pColorBuffer);
+        uint32_t* pDepth = isDepthDiscarded ? nullptr : reinterpret_cast<uint32_t*>(m_Framebuffer.m_pDepthBuffer);
+
+        const uint32_t tilePosX = static_cast<uint32_t>(m_TileList[tileIdx].m_PosX);
+        const uint32_t tilePosY = static_cast<uint32_t>(m_TileList[tileIdx].m_PosY);
+        const uint32_t numCols = glm::min(tileSize, m_Framebuffer.m_Width - tilePosX);
+        const uint32_t numRows = glm::min(tileSize, m_Framebuffer.m_Height - tilePosY);
+
+        const uint32_t fbOffset = tilePosX + tilePosY * m_Framebuffer.m_Width;
+
+        if (isTileBufferLoaded)
+        {
+            const uint32_t tileSampleOffset = tileIdx << (2 * m_TileSizeLog2);
+
+            if (pColor != nullptr)
+            {
+                ResolveTileRegion(pColor + fbOffset, m_Framebuffer.m_Width, reinterpret_cast<const uint32_t*>(m_pTileColorBuffers) + tileSampleOffset, tileSize, numCols, numRows);
+            }
+
+            if (pDepth != nullptr)
+            {
+                ResolveTileRegion(pDepth + fbOffset, m_Framebuffer.m_Width, reinterpret_cast<const uint32_t*>(m_pTileDepthBuffers) + tileSampleOffset, tileSize, numCols, numRows);
+            }
+
+            m_IsTileBufferLoaded[tileIdx] = 0u;
+        }
+        else
+        {
+            if ((fastClearFlags & g_scFastClearColor) && (pColor != nullptr))
+            {
+                for (uint32_t row = 0; row < numRows; row++)
+                {
+                    FillFramebufferRow(pColor + fbOffset + row * m_Framebuffer.m_Width, m_ColorClearValue, numCols);
+                }
+            }
+
+            if ((fastClearFlags & g_scFastClearDepth) && (pDepth != nullptr))
+            {
+                uint32_t depthClearValue;
+                memcpy(&depthClearValue, &m_DepthClearValue, sizeof(float));
+
+                for (uint32_t row = 0; row < numRows; row++)
+                {
+                    FillFramebufferRow(pDepth + fbOffset + row * m_Framebuffer.m_Width, depthClearValue, numCols);
+                }
+            }
+
+            m_FastClearFlags[tileIdx] &= static_cast<uint8_t>(~fastClearFlags);
         }
     }
 
@@ -191,6 +614,22 @@ namespace tyler
         // Pipeline threads must have been allocated!
         ASSERT(m_PipelineThreads.size() == m_RenderConfig.m_NumPipelineThreads);
 
+        // Shaders must have been bound
+        ASSERT(m_pShaderPipeline != nullptr);
+        ASSERT(m_pPipelineState != nullptr);
+        ASSERT((m_Framebuffer.m_pDepthBuffer != nullptr) || IsDepthTransient());
+
+        // Z-prepass & shadow map passes neither need attributes to be interpolated nor FS to be invoked
+        const PipelineStateDesc& stateDesc = m_pPipelineState->m_Desc;
+        m_IsDepthOnly = !m_pShaderPipeline->HasFragmentShader(this) || (m_Framebuffer.m_pColorBuffer == nullptr) || (stateDesc.m_ColorWriteMask == 0u);
+        m_FragmentStageVariant = m_IsDepthOnly ?
+            GetFragmentStageVariant(stateDesc.m_DepthFunc, stateDesc.m_DepthWriteEnabled, ColorWriteMode::NONE) :
+            m_pPipelineState->m_FragmentStageVariant;
+
+        // Subpass inputs are read at samples written by the drawcall itself, so their contents would depend on the order samples are written
+        m_IsOrderIndependent = m_pPipelineState->m_IsOrderIndependent && !m_pShaderPipeline->ReadsSubpassInput(this);
+        ASSERT(!m_IsOrderIndependent || (m_RenderConfig.m_NumPipelineThreads <= (UINT32_MAX >> g_scWorkItemIndexShift) + 1u));
+
         uint32_t numRemainingPrims = primCount;
 
         uint32_t drawElemsPrev = 0u;
@@ -198,52 +637,82 @@ namespace tyler
 
         while (numRemainingPrims > 0)
         {
+            // Data of the draw iteration that used the same DrawIteration before must have been consumed by all threads
+            WaitForPipelineThreadsToCompleteDrawIterations(g_scMaxDrawIterationsInFlight - 1);
+
+            const uint32_t iterationIdx = m_NumDispatchedIterations.load(std::memory_order_relaxed);
+            DrawIteration* pDrawIteration = &m_DrawIterations[iterationIdx % g_scMaxDrawIterationsInFlight];
+
             // Prepare for next draw iteration
-            ApplyPreDrawIterationStateInvalidations();
+            ApplyPreDrawIterationStateInvalidations(pDrawIteration);
 
             // How many prims are to be processed this iteration & prims per thread
             uint32_t iterationSize = (numRemainingPrims >= m_RenderConfig.m_MaxDrawIterationSize) ? m_RenderConfig.m_MaxDrawIterationSize : numRemainingPrims;
             uint32_t perIterationRemainder = iterationSize % m_RenderConfig.m_NumPipelineThreads;
             uint32_t primsPerThread = iterationSize / m_RenderConfig.m_NumPipelineThreads;
 
+            const uint32_t iterationStart = drawElemsPrev;
+
             for (uint32_t threadIdx = 0; threadIdx < m_RenderConfig.m_NumPipelineThreads; threadIdx++)
             {
-                uint32_t currentDrawElemsStart = drawElemsPrev;
-                uint32_t currentDrawElemsEnd = (threadIdx == (m_RenderConfig.m_NumPipelineThreads - 1)) ?
-                    // If number of remaining primitives in iteration is not multiple of number of threads, have the last thread cover the remaining range
-                    (currentDrawElemsStart + primsPerThread + perIterationRemainder) :
-                    currentDrawElemsStart + primsPerThread;
+                uint32_t currentDrawElemsStart;
+                uint32_t currentDrawElemsEnd;
+
+                if constexpr (g_scDynamicGeometryDistributionEnabled)
+                {
+                    // All threads share the whole range of the draw iteration, fetching batches of it as they go (see PipelineThread::ExecuteGeometry())
+                    currentDrawElemsStart = iterationStart;
+                    currentDrawElemsEnd = iterationStart + iterationSize;
+                }
+                else
+                {
+                    currentDrawElemsStart = drawElemsPrev;
+                    currentDrawElemsEnd = (threadIdx == (m_RenderConfig.m_NumPipelineThreads - 1)) ?
+                        // If number of remaining primitives in iteration is not multiple of number of threads, have the last thread cover the remaining range
+                        (currentDrawElemsStart + primsPerThread + perIterationRemainder) :
+                        currentDrawElemsStart + primsPerThread;
+
+                    drawElemsPrev = currentDrawElemsEnd;
+                }
 
                 ASSERT(currentDrawElemsEnd <= primCount);
 
-                // Threads must have been initialized and idle by now!
+                // Threads must have been initialized by now, though they may still be processing previous draw iterations
                 PipelineThread* pThread = m_PipelineThreads[threadIdx];
-                ASSERT((pThread != nullptr) && (pThread->m_CurrentState.load() == ThreadStatus::IDLE));
+                ASSERT(pThread != nullptr);
 
                 // Assign computed draw elems range for thread
-                pThread->m_ActiveDrawParams.m_ElemsStart = currentDrawElemsStart;
-                pThread->m_ActiveDrawParams.m_ElemsEnd = currentDrawElemsEnd;
-                pThread->m_ActiveDrawParams.m_VertexOffset = vertexOffset;
-                pThread->m_ActiveDrawParams.m_IsIndexed = isIndexed;
+                PipelineThread::DrawParams& drawParams = pThread->m_DrawParams[iterationIdx % g_scMaxDrawIterationsInFlight];
+                drawParams.m_ElemsStart = currentDrawElemsStart;
+                drawParams.m_ElemsEnd = currentDrawElemsEnd;
+                drawParams.m_VertexOffset = vertexOffset;
+                drawParams.m_IsIndexed = isIndexed;
 
                 LOG("Thread %d drawparams for iteration %d: (%d, %d)\n", threadIdx, numIter, currentDrawElemsStart, currentDrawElemsEnd);
+            }
 
-                // PipelineThread drawcall input prepared, it can start processing of drawcall
-                pThread->m_CurrentState.store(ThreadStatus::DRAWCALL_TOP, std::memory_order_release);
+            drawElemsPrev = iterationStart + iterationSize;
+            numRemainingPrims -= iterationSize;
 
-                drawElemsPrev = currentDrawElemsEnd;
-                numRemainingPrims -= (currentDrawElemsEnd - currentDrawElemsStart);
+            if constexpr (g_scWakeUpStatsEnabled)
+            {
+                pDrawIteration->m_DispatchTime = std::chrono::steady_clock::now();
             }
 
-            // All threads are assigned draw parameters, let them work now
-            m_DrawcallSetupComplete.store(true, std::memory_order_release);
+            // All threads are assigned draw parameters, let them work now (right after they're done with previous draw iterations)
+            m_NumDispatchedIterations.store(iterationIdx + 1, std::memory_order_release);
 
-            // Stall main thread until all active threads complete given draw iteration
-            WaitForPipelineThreadsToCompleteProcessingDrawcall();
+            for (uint32_t threadIdx = 0; threadIdx < m_RenderConfig.m_NumPipelineThreads; threadIdx++)
+            {
+                m_PipelineThreads[threadIdx]->m_WakeUpEvent.NotifyAll();
+            }
 
-            LOG("Iteration %d completed!\n", numIter++);
+            LOG("Iteration %d dispatched!\n", numIter++);
         }
 
+        // Stall main thread until all active threads complete all draw iterations
+        WaitForPipelineThreadsToCompleteDrawIterations(0u);
+
 #if _DEBUG
         // All threads must be idle and ready for next drawcall at this point
         for (PipelineThread* pThread : m_PipelineThreads)
@@ -270,21 +739,28 @@ namespace tyler
         }
     }
 
-    void RenderEngine::ApplyPreDrawIterationStateInvalidations()
+    void RenderEngine::ApplyPreDrawIterationStateInvalidations(DrawIteration* pDrawIteration)
     {
         ASSERT((m_NumTilePerColumn > 0) && (m_NumTilePerRow > 0));
-        ASSERT(!m_TileList.empty());
+        ASSERT(pDrawIteration->m_TileStates.size() == m_TileList.size());
 
-        // Clear tile flags in allocated tiles list
-        for (Tile& tile : m_TileList)
+        // Clear tile flags of the draw iteration
+        for (TileIterationState& tileState : pDrawIteration->m_TileStates)
         {
-            tile.m_IsTileQueued.clear(std::memory_order_relaxed);
+            tileState.m_IsTileQueued.clear(std::memory_order_relaxed);
+            tileState.m_IsTileRasterized.store(false, std::memory_order_relaxed);
+
+            // Tile is fragment-shaded as a whole unless it's split
+            tileState.m_NumWorkItems = 1u;
+            tileState.m_IsTileBufferLoadStarted.clear(std::memory_order_relaxed);
+            tileState.m_IsTileBufferLoadComplete.store(false, std::memory_order_relaxed);
+            tileState.m_NumWorkItemsShaded.store(0u, std::memory_order_relaxed);
         }
 
-        ASSERT(!m_BinList.empty());
+        ASSERT(!pDrawIteration->m_BinList.empty());
 
         // Clear binned primitives list
-        for (auto& perTileList : m_BinList)
+        for (auto& perTileList : pDrawIteration->m_BinList)
         {
             ASSERT(!perTileList.empty());
 
@@ -295,137 +771,454 @@ namespace tyler
         }
 
         // Reset coverage mask buffers
-        for (auto& perThreadCoverageMask : m_CoverageMasks)
+        for (auto& perThreadCoverageMask : pDrawIteration->m_CoverageMasks)
         {
             for (auto& coverageMaskBuffer : perThreadCoverageMask)
             {
-                coverageMaskBuffer->ResetAllocationList();
+                // Not allocated yet if the thread hasn't processed the draw iteration since RTs were resized
+                if (coverageMaskBuffer != nullptr)
+                {
+                    coverageMaskBuffer->ResetAllocationList();
+                }
             }
         }
 
         // Reset rasterizer queue
-        m_RasterizerQueue.ResetQueue();
+        pDrawIteration->m_RasterizerQueue.ResetQueue();
 
-        // Clear drawcall setup flag
-        m_DrawcallSetupComplete.store(false, std::memory_order_relaxed);
+        // No primitives of the draw iteration are fetched/binned yet
+        pDrawIteration->m_NextGeometryBatchOffset.store(0u, std::memory_order_relaxed);
+        pDrawIteration->m_NumThreadsBinned.store(0u, std::memory_order_relaxed);
+        pDrawIteration->m_IsBinningComplete.store(false, std::memory_order_relaxed);
+    }
 
-#ifdef _DEBUG
-        // Clear per-thread drawparams for debug
-        for (PipelineThread* pThread : m_PipelineThreads)
+    void RenderEngine::WaitForPipelineThreadsToCompleteDrawIterations(uint32_t maxNumIterationsInFlight)
+    {
+        // Only the main thread dispatches draw iterations
+        const uint32_t numDispatchedIterations = m_NumDispatchedIterations.load(std::memory_order_relaxed);
+
+        // Spin, then park until active threads are done with all but the last maxNumIterationsInFlight draw iterations
+        m_ThreadCompletionEvent.Wait([&]()
         {
-            ASSERT(pThread != nullptr);
-            memset(&pThread->m_ActiveDrawParams, 0x0, sizeof(PipelineThread::DrawParams));
-        }
-#endif
+            bool threadsComplete = true;
+            for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
+            {
+                PipelineThread* pThread = m_PipelineThreads[i];
+                ASSERT(pThread != nullptr);
+
+                // Unsigned difference holds when iteration counters wrap around
+                threadsComplete = threadsComplete &&
+                    ((numDispatchedIterations - pThread->m_NumCompletedIterations.load(std::memory_order_acquire)) <= maxNumIterationsInFlight);
+            }
+
+            return threadsComplete;
+        });
     }
 
-    void RenderEngine::WaitForPipelineThreadsToCompleteProcessingDrawcall() const
+    void RenderEngine::WaitForPipelineThreadsToCompleteResolve()
     {
-        bool drawcallComplete = false;
-        while (!drawcallComplete) // Spin until active threads reach the bottom of drawcall pipeline
+        // Spin, then park until all threads run out of tiles to resolve and go back to idle
+        m_ThreadCompletionEvent.Wait([this]()
         {
-            bool threadComplete = true;
+            bool threadsComplete = true;
             for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
             {
                 PipelineThread* pThread = m_PipelineThreads[i];
                 ASSERT(pThread != nullptr);
 
-                threadComplete = threadComplete &&
-                    (pThread->m_CurrentState.load(std::memory_order_relaxed) == ThreadStatus::DRAWCALL_BOTTOM);
+                threadsComplete = threadsComplete &&
+                    (pThread->m_CurrentState.load(std::memory_order_acquire) == ThreadStatus::IDLE);
             }
 
-            drawcallComplete = threadComplete;
+            return threadsComplete;
+        });
+    }
+
+    void RenderEngine::WaitForPipelineThreadsToCompleteBinning(DrawIteration* pDrawIteration)
+    {
+        // Spin, then park until active threads reach post binner of the draw iteration
+        // Threads may be in different pipeline stages of different draw iterations, so binned threads are counted per draw iteration instead of checking thread states
+        m_SyncPointEvent.Wait([&]()
+        {
+            return pDrawIteration->m_IsBinningComplete.load(std::memory_order_acquire);
+        });
+    }
+
+    void RenderEngine::SignalBinningComplete(DrawIteration* pDrawIteration)
+    {
+        ASSERT(pDrawIteration->m_NumThreadsBinned.load(std::memory_order_relaxed) == m_RenderConfig.m_NumPipelineThreads);
+
+        // All tiles are queued now, and none can be fetched before binning completion is signaled
+        // Queue is sorted once: cost-aware scheduling applies dispatch order itself, among tiles of similar cost
+        if constexpr (g_scCostAwareTileSchedulingEnabled)
+        {
+            ScheduleQueuedTilesByCost(pDrawIteration);
+        }
+        else if constexpr (g_scTileDispatchOrder != TileDispatchOrder::BINNING)
+        {
+            ScheduleQueuedTilesByDispatchOrder(pDrawIteration);
+        }
+
+        if (m_IsOrderIndependent)
+        {
+            SplitQueuedTilesByThreadBins(pDrawIteration);
+        }
+
+        pDrawIteration->m_IsBinningComplete.store(true, std::memory_order_release);
+        m_SyncPointEvent.NotifyAll();
+    }
+
+    void RenderEngine::ScheduleQueuedTilesByDispatchOrder(DrawIteration* pDrawIteration)
+    {
+        pDrawIteration->m_RasterizerQueue.SortTileIndices([&](uint32_t tileIdx0, uint32_t tileIdx1)
+        {
+            return (m_TileList[tileIdx0].m_DispatchOrder < m_TileList[tileIdx1].m_DispatchOrder);
+        });
+    }
+
+    uint32_t RenderEngine::ComputeTileDispatchOrder(uint32_t tileX, uint32_t tileY) const
+    {
+        ASSERT((tileX < m_NumTilePerRow) && (tileY < m_NumTilePerColumn));
+
+        switch (g_scTileDispatchOrder)
+        {
+        case TileDispatchOrder::MORTON:
+        {
+            // Interleave bits of tile coordinates
+            uint32_t order = 0u;
+            for (uint32_t bit = 0; bit < 16u; bit++)
+            {
+                order |= ((tileX >> bit) & 1u) << (2u * bit);
+                order |= ((tileY >> bit) & 1u) << (2u * bit + 1u);
+            }
 
-            std::this_thread::yield();
+            return order;
         }
+        case TileDispatchOrder::HILBERT:
+        {
+            // Curve covers the smallest power-of-two square grid of tiles enclosing the framebuffer
+            uint32_t gridSize = 1u;
+            while ((gridSize < m_NumTilePerRow) || (gridSize < m_NumTilePerColumn))
+            {
+                gridSize *= 2u;
+            }
+
+            uint32_t x = tileX;
+            uint32_t y = tileY;
+            uint32_t order = 0u;
+            for (uint32_t s = gridSize / 2u; s > 0u; s /= 2u)
+            {
+                const uint32_t rx = ((x & s) != 0u) ? 1u : 0u;
+                const uint32_t ry = ((y & s) != 0u) ? 1u : 0u;
+                order += s * s * ((3u * rx) ^ ry);
 
-        // All threads finished drawcall processing, set their states to IDLE before next iteration
-        for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
+                // Rotate quadrant so that the curve within it starts & ends next to adjacent quadrants
+                if (ry == 0u)
+                {
+                    if (rx == 1u)
+                    {
+                        x = gridSize - 1u - x;
+                        y = gridSize - 1u - y;
+                    }
+
+                    std::swap(x, y);
+                }
+            }
+
+            return order;
+        }
+        case TileDispatchOrder::SCREEN_REGION:
         {
-            PipelineThread* pThread = m_PipelineThreads[i];
-            ASSERT((pThread != nullptr) && (pThread->m_CurrentState.load() == ThreadStatus::DRAWCALL_BOTTOM));
+            // Rank of the tile within its band, interleaved with other bands
+            const uint32_t numRegions = m_RenderConfig.m_NumPipelineThreads;
+            const uint32_t regionIdx = (tileY * numRegions) / m_NumTilePerColumn;
+            const uint32_t regionMinY = (regionIdx * m_NumTilePerColumn + numRegions - 1u) / numRegions;
 
-            pThread->m_CurrentState.store(ThreadStatus::IDLE, std::memory_order_relaxed);
+            return ((tileY - regionMinY) * m_NumTilePerRow + tileX) * numRegions + regionIdx;
+        }
+        case TileDispatchOrder::BINNING:
+        case TileDispatchOrder::ROW_MAJOR:
+        default:
+            return GetGlobalTileIndex(tileX, tileY);
         }
     }
 
-    void RenderEngine::WaitForPipelineThreadsToCompleteBinning() const
+    void RenderEngine::ScheduleQueuedTilesByCost(DrawIteration* pDrawIteration)
     {
-        bool binningComplete = false;
-        while (!binningComplete) // Spin until active threads reach post binner
+        TileQueue& tileQueue = pDrawIteration->m_RasterizerQueue;
+        const uint32_t numQueuedTiles = tileQueue.m_WriteIdx.load(std::memory_order_relaxed);
+
+        // Estimate cost of each queued tile by the # primitives that cover it, which is what rasterization & fragment shading of a tile scale with.
+        // A trivially accepting primitive fragment-shades every block of the tile, so it weighs as much as the # blocks in a tile
+        const uint32_t trivialAcceptCost = (m_RenderConfig.m_TileSize / g_scPixelBlockSize) * (m_RenderConfig.m_TileSize / g_scPixelBlockSize);
+
+        uint64_t totalEstimatedCost = 0u;
+        for (uint32_t i = 0; i < numQueuedTiles; i++)
         {
-            bool threadsComplete = true;
-            for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
+            const uint32_t tileIdx = tileQueue.m_pData[i];
+
+            uint32_t estimatedCost = 0u;
+            for (uint32_t threadIdx = 0; threadIdx < m_RenderConfig.m_NumPipelineThreads; threadIdx++)
             {
-                PipelineThread* pThread = m_PipelineThreads[i];
-                ASSERT(pThread != nullptr);
+                const std::vector<uint32_t>& bin = pDrawIteration->m_BinList[tileIdx][threadIdx];
 
-                ThreadStatus expected = ThreadStatus::DRAWCALL_SYNC_POINT_POST_BINNER;
-                threadsComplete = threadsComplete &&
-                    (pThread->m_CurrentState.compare_exchange_weak(expected, ThreadStatus::DRAWCALL_RASTERIZATION, std::memory_order_acq_rel) ||
-                    (expected >= ThreadStatus::DRAWCALL_RASTERIZATION));
+                if constexpr (g_scBinnerEmitsTrivialAcceptMasks)
+                {
+                    // Trivially accepting primitives are emitted as TA coverage masks by the binner, bins only hold partially covering ones
+                    estimatedCost += static_cast<uint32_t>(bin.size());
+                    estimatedCost += pDrawIteration->m_CoverageMasks[tileIdx][threadIdx]->GetNumCoverageMasks() * trivialAcceptCost;
+                }
+                else
+                {
+                    // Trivially accepting primitives are flagged in bins
+                    for (uint32_t binnedPrimIdx : bin)
+                    {
+                        estimatedCost += ((binnedPrimIdx & g_scBinnedPrimTrivialAcceptFlag) != 0u) ? trivialAcceptCost : 1u;
+                    }
+                }
+            }
 
-                ASSERT((expected >= ThreadStatus::DRAWCALL_TOP) && (expected <= ThreadStatus::DRAWCALL_FRAGMENTSHADER));
+            pDrawIteration->m_TileStates[tileIdx].m_EstimatedCost = estimatedCost;
+            totalEstimatedCost += estimatedCost;
+        }
+
+        // Estimated costs are coarse, so tiles are ranked by cost class rather than exact cost: heavy tiles (which are split below) come first,
+        // followed by the rest of tiles by the power of two their cost falls below
+        for (uint32_t i = 0; i < numQueuedTiles; i++)
+        {
+            TileIterationState& tileState = pDrawIteration->m_TileStates[tileQueue.m_pData[i]];
+
+            if ((static_cast<uint64_t>(tileState.m_EstimatedCost) * m_RenderConfig.m_NumPipelineThreads) > totalEstimatedCost)
+            {
+                tileState.m_CostClass = UINT32_MAX;
+            }
+            else
+            {
+                tileState.m_CostClass = 0u;
+                while ((tileState.m_EstimatedCost >> tileState.m_CostClass) != 0u)
+                {
+                    tileState.m_CostClass++;
+                }
+            }
+        }
+
+        // Heaviest tiles first, so that threads run out of work at about the same time at the end of the draw iteration.
+        // Tiles of the same cost class are dispatched in g_scTileDispatchOrder
+        tileQueue.SortTileIndices([&](uint32_t tileIdx0, uint32_t tileIdx1)
+        {
+            const uint32_t costClass0 = pDrawIteration->m_TileStates[tileIdx0].m_CostClass;
+            const uint32_t costClass1 = pDrawIteration->m_TileStates[tileIdx1].m_CostClass;
+
+            if constexpr (g_scTileDispatchOrder != TileDispatchOrder::BINNING)
+            {
+                if (costClass0 == costClass1)
+                {
+                    return (m_TileList[tileIdx0].m_DispatchOrder < m_TileList[tileIdx1].m_DispatchOrder);
+                }
+            }
+
+            return (costClass0 > costClass1);
+        });
+
+        // Tiles of order-independent drawcalls are split by per-thread bins instead
+        if (g_scTileSplittingEnabled && !m_IsOrderIndependent)
+        {
+            const uint32_t numSubTiles = glm::min(g_scMaxSubTilesPerTile, m_RenderConfig.m_TileSize / g_scPixelBlockSize);
+            if (numSubTiles < 2u)
+            {
+                // Tiles are a single block row
+                return;
             }
 
-            binningComplete = threadsComplete;
+            // A tile estimated to take longer than an equal share of all threads' work keeps a single thread busy after the others are done
+            // Heavy tiles come first in the queue, so are their sub-tiles after splitting
+            uint32_t numHeavyTiles = 0u;
+            while ((numHeavyTiles < numQueuedTiles) &&
+                ((static_cast<uint64_t>(pDrawIteration->m_TileStates[tileQueue.m_pData[numHeavyTiles]].m_EstimatedCost) * m_RenderConfig.m_NumPipelineThreads) > totalEstimatedCost))
+            {
+                pDrawIteration->m_TileStates[tileQueue.m_pData[numHeavyTiles]].m_NumWorkItems = numSubTiles;
+                numHeavyTiles++;
+            }
 
-            std::this_thread::yield();
+            if (numHeavyTiles > 0u)
+            {
+                LOG("Splitting %d heavy tiles into %d sub-tiles\n", numHeavyTiles, numSubTiles);
+
+                tileQueue.SplitTileIndices(numHeavyTiles, numSubTiles, [](uint32_t, uint32_t) { return true; });
+            }
         }
     }
 
-    void RenderEngine::WaitForPipelineThreadsToCompleteRasterization() const
+    void RenderEngine::SplitQueuedTilesByThreadBins(DrawIteration* pDrawIteration)
     {
-        bool rasterComplete = false;
-        while (!rasterComplete) // Spin until active threads reach post raster
+        TileQueue& tileQueue = pDrawIteration->m_RasterizerQueue;
+        const uint32_t numQueuedTiles = tileQueue.m_WriteIdx.load(std::memory_order_relaxed);
+
+        // Only per-thread bins with any primitives (or TA coverage masks emitted by the binner) need to be processed
+        auto IsThreadBinNonEmpty = [&](uint32_t tileIdx, uint32_t threadIdx)
         {
-            bool threadsComplete = true;
-            for (uint32_t i = 0; i < m_RenderConfig.m_NumPipelineThreads; i++)
+            bool isNonEmpty = !pDrawIteration->m_BinList[tileIdx][threadIdx].empty();
+
+            if constexpr (g_scBinnerEmitsTrivialAcceptMasks)
             {
-                PipelineThread* pThread = m_PipelineThreads[i];
-                ASSERT(pThread->m_CurrentState.load() != ThreadStatus::IDLE);
+                isNonEmpty = isNonEmpty || (pDrawIteration->m_CoverageMasks[tileIdx][threadIdx]->GetNumCoverageMasks() > 0u);
+            }
 
-                ThreadStatus expected = ThreadStatus::DRAWCALL_SYNC_POINT_POST_RASTER;
-                threadsComplete = threadsComplete &&
-                    (pThread->m_CurrentState.compare_exchange_weak(expected, ThreadStatus::DRAWCALL_FRAGMENTSHADER, std::memory_order_acq_rel) ||
-                    (expected >= ThreadStatus::DRAWCALL_FRAGMENTSHADER));
+            return isNonEmpty;
+        };
+
+        for (uint32_t i = 0; i < numQueuedTiles; i++)
+        {
+            const uint32_t tileIdx = tileQueue.m_pData[i];
 
-                ASSERT((expected >= ThreadStatus::DRAWCALL_RASTERIZATION) && (expected <= ThreadStatus::DRAWCALL_BOTTOM));
+            uint32_t numWorkItems = 0u;
+            for (uint32_t threadIdx = 0; threadIdx < m_RenderConfig.m_NumPipelineThreads; threadIdx++)
+            {
+                numWorkItems += IsThreadBinNonEmpty(tileIdx, threadIdx) ? 1u : 0u;
             }
 
-            rasterComplete = threadsComplete;
+            pDrawIteration->m_TileStates[tileIdx].m_NumWorkItems = numWorkItems;
+        }
+
+        tileQueue.SplitTileIndices(numQueuedTiles, m_RenderConfig.m_NumPipelineThreads, IsThreadBinNonEmpty);
+    }
+
+    void RenderEngine::LoadTileBuffersForFragmentShading(DrawIteration* pDrawIteration, uint32_t tileIdx)
+    {
+        TileIterationState& tileState = pDrawIteration->m_TileStates[tileIdx];
+
+        if (tileState.m_NumWorkItems == 1u)
+        {
+            // Whole tile is owned by the callee
+            LoadTileBuffers(tileIdx);
+        }
+        else if (!tileState.m_IsTileBufferLoadStarted.test_and_set(std::memory_order_acq_rel))
+        {
+            // First thread to fragment-shade a work item of the tile, load whole tile buffers on behalf of threads fragment-shading other work items
+            LoadTileBuffers(tileIdx);
+
+            tileState.m_IsTileBufferLoadComplete.store(true, std::memory_order_release);
+            m_TileShadingEvent.NotifyAll();
+        }
+        else
+        {
+            m_TileShadingEvent.Wait([&]()
+            {
+                return tileState.m_IsTileBufferLoadComplete.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    void RenderEngine::SignalTileRasterizationComplete(DrawIteration* pDrawIteration, uint32_t tileIdx)
+    {
+        pDrawIteration->m_TileStates[tileIdx].m_IsTileRasterized.store(true, std::memory_order_release);
+        m_TileRasterizationEvent.NotifyAll();
+    }
+
+    void RenderEngine::WaitForTileToCompleteRasterization(DrawIteration* pDrawIteration, uint32_t tileIdx)
+    {
+        // Tile was fetched by a rasterizer already, so it's only a matter of time for the tile to be rasterized
+        m_TileRasterizationEvent.Wait([&]()
+        {
+            return pDrawIteration->m_TileStates[tileIdx].m_IsTileRasterized.load(std::memory_order_acquire);
+        });
+    }
+
+    void RenderEngine::SignalTileShadingComplete(DrawIteration* pDrawIteration, uint32_t tileIdx)
+    {
+        TileIterationState& tileState = pDrawIteration->m_TileStates[tileIdx];
+
+        if ((tileState.m_NumWorkItems > 1u) && (tileState.m_NumWorkItemsShaded.fetch_add(1u, std::memory_order_acq_rel) != (tileState.m_NumWorkItems - 1u)))
+        {
+            // Other work items of the tile are still being fragment-shaded, the last one to complete marks the whole tile
+            return;
+        }
+
+        m_TileList[tileIdx].m_NumShadedIterations.store(tileState.m_ShadingOrder + 1, std::memory_order_release);
+        m_TileShadingEvent.NotifyAll();
+    }
+
+    void RenderEngine::WaitForTileToCompleteShadingOfPreviousIterations(DrawIteration* pDrawIteration, uint32_t tileIdx)
+    {
+        // Previous draw iterations have all passed binning already, so the tile is only waited on by threads that fetched it in those
+        const uint32_t shadingOrder = pDrawIteration->m_TileStates[tileIdx].m_ShadingOrder;
+
+        m_TileShadingEvent.Wait([&]()
+        {
+            return (m_TileList[tileIdx].m_NumShadedIterations.load(std::memory_order_acquire) == shadingOrder);
+        });
+    }
+
+    void RenderEngine::GetThreadWakeUpStats(ThreadWakeUpStats* pStats) const
+    {
+        ASSERT(pStats != nullptr);
+
+        uint64_t totalLatency = 0u;
+        uint64_t maxLatency = 0u;
 
-            std::this_thread::yield();
+        *pStats = ThreadWakeUpStats{};
+        for (const PipelineThread* pThread : m_PipelineThreads)
+        {
+            pStats->m_NumWakeUps += pThread->m_NumWakeUps;
+            pStats->m_NumParks += pThread->m_WakeUpEvent.m_NumParks.load(std::memory_order_relaxed);
+            totalLatency += pThread->m_TotalWakeUpLatency;
+            maxLatency = glm::max(maxLatency, pThread->m_MaxWakeUpLatency);
+        }
+
+        pStats->m_NumParks += m_SyncPointEvent.m_NumParks.load(std::memory_order_relaxed) + m_ThreadCompletionEvent.m_NumParks.load(std::memory_order_relaxed) +
+            m_TileRasterizationEvent.m_NumParks.load(std::memory_order_relaxed) + m_TileShadingEvent.m_NumParks.load(std::memory_order_relaxed);
+        pStats->m_AvgLatencyUs = (pStats->m_NumWakeUps > 0u) ? (1e-3 * static_cast<double>(totalLatency) / static_cast<double>(pStats->m_NumWakeUps)) : 0.0;
+        pStats->m_MaxLatencyUs = 1e-3 * static_cast<double>(maxLatency);
+    }
+
+    void RenderEngine::ResetThreadWakeUpStats()
+    {
+        for (PipelineThread* pThread : m_PipelineThreads)
+        {
+            pThread->m_NumWakeUps = 0u;
+            pThread->m_TotalWakeUpLatency = 0u;
+            pThread->m_MaxWakeUpLatency = 0u;
+            pThread->m_WakeUpEvent.m_NumParks.store(0u, std::memory_order_relaxed);
         }
+
+        m_SyncPointEvent.m_NumParks.store(0u, std::memory_order_relaxed);
+        m_ThreadCompletionEvent.m_NumParks.store(0u, std::memory_order_relaxed);
+        m_TileRasterizationEvent.m_NumParks.store(0u, std::memory_order_relaxed);
+        m_TileShadingEvent.m_NumParks.store(0u, std::memory_order_relaxed);
     }
 
-    void RenderEngine::EnqueueTileForRasterization(uint32_t tileIdx)
+    void RenderEngine::EnqueueTileForRasterization(DrawIteration* pDrawIteration, uint32_t tileIdx)
     {
         ASSERT(tileIdx < (m_NumTilePerColumn * m_NumTilePerRow));
 
+        TileIterationState& tileState = pDrawIteration->m_TileStates[tileIdx];
+
         // Append the tile to the rasterizer queue if not already done
-        if (!m_TileList[tileIdx].m_IsTileQueued.test_and_set(std::memory_order_acq_rel))
+        if (!tileState.m_IsTileQueued.test_and_set(std::memory_order_acq_rel))
         {
+            // Binning of draw iterations is done in order, so is queuing a tile in them
+            tileState.m_ShadingOrder = m_TileList[tileIdx].m_NumQueuedIterations++;
+
             // Tile not queued up for rasterization, do so now
-            m_RasterizerQueue.InsertTileIndex(tileIdx);
+            pDrawIteration->m_RasterizerQueue.InsertTileIndex(tileIdx);
         }
     }
 
-    void RenderEngine::BinPrimitiveForTile(uint32_t threadIdx, uint32_t tileIdx, uint32_t primIdx)
+    void RenderEngine::BinPrimitiveForTile(DrawIteration* pDrawIteration, uint32_t threadIdx, uint32_t tileIdx, uint32_t primIdx)
     {
         // Add primIdx to the per-thread bin of a tile
 
-        std::vector<uint32_t>& tileBin = m_BinList[tileIdx][threadIdx];
+        std::vector<uint32_t>& tileBin = pDrawIteration->m_BinList[tileIdx][threadIdx];
 
         if (tileBin.empty())
         {
             // First encounter of primitive for tile, enqueue it for rasterization
-            EnqueueTileForRasterization(tileIdx);
+            EnqueueTileForRasterization(pDrawIteration, tileIdx);
         }
         else
         {
             // Tile must have been already appended to the work queue
-            ASSERT(m_TileList[tileIdx].m_IsTileQueued.test_and_set());
+            ASSERT(pDrawIteration->m_TileStates[tileIdx].m_IsTileQueued.test_and_set());
         }
 
         auto capPreAppend = tileBin.capacity();
@@ -436,42 +1229,130 @@ namespace tyler
         auto capPostAppend = tileBin.capacity();
 
         // Underlying tile bin vector must not have caused resizing when appending primitives to tiles!
-        ASSERT(capPreAppend == capPostAppend);
+        // Unless threads fetch primitives dynamically, in which case a thread may bin more than its share of the draw iteration to a tile
+        ASSERT(g_scDynamicGeometryDistributionEnabled || (capPreAppend == capPostAppend));
     }
 
-    void RenderEngine::AppendCoverageMask(uint32_t threadIdx, uint32_t tileIdx, const CoverageMask& mask)
+    void RenderEngine::AppendCoverageMask(DrawIteration* pDrawIteration, uint32_t threadIdx, uint32_t tileIdx, const CoverageMask& mask)
     {
-        m_CoverageMasks[tileIdx][threadIdx]->AppendCoverageMask(mask);
+        pDrawIteration->m_CoverageMasks[tileIdx][threadIdx]->AppendCoverageMask(mask);
     }
 
-    void RenderEngine::ResizeCoverageMaskBuffer(uint32_t threadIdx, uint32_t tileIdx)
+    void RenderEngine::UpdateDepthBuffer(const __m128& sseWriteMask, const __m128& sseDepthValues, uint32_t sampleX, uint32_t sampleY)
     {
-        m_CoverageMasks[tileIdx][threadIdx]->IncreaseCapacityIfNeeded();
+        uint32_t depthPitch;
+        float* pDepthBufferAddress = GetDepthBufferAddress(sampleX, sampleY, &depthPitch);
+
+        if constexpr (g_scIsSampleGroupContiguous)
+        {
+            // Merge with current contents and store SIMD group at once
+            _mm_store_ps(pDepthBufferAddress, _mm_blendv_ps(_mm_load_ps(pDepthBufferAddress), sseDepthValues, sseWriteMask));
+        }
+        else if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
+        {
+            // Quad spans two rows, so merge with current contents and store two samples per row
+            __m128 sseDepthMerged = _mm_blendv_ps(FetchDepthBuffer(sampleX, sampleY), sseDepthValues, sseWriteMask);
+
+            _mm_storel_pi(reinterpret_cast<__m64*>(pDepthBufferAddress), sseDepthMerged);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(pDepthBufferAddress + depthPitch), sseDepthMerged);
+        }
+        else
+        {
+            __m128i sseZInterpolated = _mm_castps_si128(sseDepthValues);
+
+            // Mask-store interpolated Z values
+            _mm_maskmoveu_si128( // There is no _mm_maskstore_ps() in SSE so we mask-store 4-sample FP32 values as raw bytes
+                sseZInterpolated,
+                _mm_castps_si128(sseWriteMask),
+                reinterpret_cast<char*>(pDepthBufferAddress));
+        }
     }
 
-    void RenderEngine::UpdateDepthBuffer(const __m128& sseWriteMask, const __m128& sseDepthValues, uint32_t sampleX, uint32_t sampleY)
+    void RenderEngine::StoreDepthBuffer(const __m128& sseDepthValues, uint32_t sampleX, uint32_t sampleY)
     {
-        __m128i sseZInterpolated = _mm_castps_si128(sseDepthValues);
+        uint32_t depthPitch;
+        float* pDepthBufferAddress = GetDepthBufferAddress(sampleX, sampleY, &depthPitch);
 
-        uint32_t depthPitch = m_Framebuffer.m_Width;
-        float* pDepthBufferAddress = &m_Framebuffer.m_pDepthBuffer[sampleX + sampleY * depthPitch];
-
-        // Mask-store interpolated Z values
-        _mm_maskmoveu_si128( // There is no _mm_maskstore_ps() in SSE so we mask-store 4-sample FP32 values as raw bytes
-            sseZInterpolated,
-            _mm_castps_si128(sseWriteMask),
-            reinterpret_cast<char*>(pDepthBufferAddress));
+        if constexpr (g_scIsSampleGroupContiguous)
+        {
+            _mm_store_ps(pDepthBufferAddress, sseDepthValues);
+        }
+        else if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
+        {
+            // Two samples to each of the two rows
+            _mm_storel_pi(reinterpret_cast<__m64*>(pDepthBufferAddress), sseDepthValues);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(pDepthBufferAddress + depthPitch), sseDepthValues);
+        }
+        else
+        {
+            _mm_store_ps(pDepthBufferAddress, sseDepthValues);
+        }
     }
 
     __m128 RenderEngine::FetchDepthBuffer(uint32_t sampleX, uint32_t sampleY) const
     {
         // Load current depth buffer contents
-        uint32_t depthPitch = m_Framebuffer.m_Width;
-        float* pDepthBufferAddress = &m_Framebuffer.m_pDepthBuffer[sampleX + sampleY * depthPitch];
+        uint32_t depthPitch;
+        float* pDepthBufferAddress = GetDepthBufferAddress(sampleX, sampleY, &depthPitch);
 
-        return _mm_load_ps(pDepthBufferAddress);
+        if constexpr (g_scIsSampleGroupContiguous)
+        {
+            return _mm_load_ps(pDepthBufferAddress);
+        }
+        else if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
+        {
+            // Two samples from each of the two rows
+            __m128 sseDepthRow0 = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(pDepthBufferAddress));
+            return _mm_loadh_pi(sseDepthRow0, reinterpret_cast<const __m64*>(pDepthBufferAddress + depthPitch));
+        }
+        else
+        {
+            return _mm_load_ps(pDepthBufferAddress);
+        }
+    }
+
+    void RenderEngine::FetchColorBuffer(uint32_t sampleX, uint32_t sampleY, __m128* pSSEColors) const
+    {
+        uint32_t colorPitch;
+        const uint8_t* pColorBufferAddress = GetColorBufferAddress(sampleX, sampleY, &colorPitch);
+
+        __m128i sseColorCurrent;
+        if constexpr (g_scIsSampleGroupContiguous)
+        {
+            sseColorCurrent = _mm_load_si128(reinterpret_cast<const __m128i*>(pColorBufferAddress));
+        }
+        else if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
+        {
+            // Two samples from each of the two rows
+            sseColorCurrent = _mm_unpacklo_epi64(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pColorBufferAddress)),
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pColorBufferAddress + colorPitch)));
+        }
+        else
+        {
+            sseColorCurrent = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pColorBufferAddress));
+        }
+
+        // rgba = cast<float>(rgba) / 255.f
+        const __m128 sseScale = _mm_set1_ps(1.f / 255.f);
+
+        pSSEColors[0] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(sseColorCurrent)), sseScale);
+        pSSEColors[1] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(sseColorCurrent, 4))), sseScale);
+        pSSEColors[2] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(sseColorCurrent, 8))), sseScale);
+        pSSEColors[3] = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(sseColorCurrent, 12))), sseScale);
+    }
+
+    float RenderEngine::FetchHiZValue(uint32_t sampleX, uint32_t sampleY) const
+    {
+        return m_HiZBuffer[(sampleX / g_scPixelBlockSize) + (sampleY / g_scPixelBlockSize) * m_NumBlockPerRow];
+    }
+
+    void RenderEngine::UpdateHiZValue(float maxDepth, uint32_t sampleX, uint32_t sampleY)
+    {
+        m_HiZBuffer[(sampleX / g_scPixelBlockSize) + (sampleY / g_scPixelBlockSize) * m_NumBlockPerRow] = maxDepth;
     }
 
+    template<bool IsColorWriteMasked>
     void RenderEngine::UpdateColorBuffer(const __m128& sseWriteMask, const FragmentOutput& fragmentOutput, uint32_t sampleX, uint32_t sampleY)
     {
         //TODO: Clamp fragments to (0.0, 1.0) first maybe?!
@@ -502,13 +1383,117 @@ namespace tyler
             _mm_cvtsi128_si32(sseSample2),
             _mm_cvtsi128_si32(sseSample3));
 
-        uint32_t colorPitch = m_Framebuffer.m_Width * 4;
-        uint8_t* pColorBufferAddress = &m_Framebuffer.m_pColorBuffer[4 * sampleX + sampleY * colorPitch];
+        UpdateColorBufferRGBA8<IsColorWriteMasked>(sseWriteMask, sseFragmentOut, sampleX, sampleY);
+    }
+
+    template<bool IsColorWriteMasked>
+    void RenderEngine::UpdateColorBufferRGBA8(const __m128& sseWriteMask, const __m128i& sseFragmentOut, uint32_t sampleX, uint32_t sampleY)
+    {
+        // Byte mask of samples & channels to be written
+        __m128i sseByteWriteMask = _mm_castps_si128(sseWriteMask);
+        if constexpr (IsColorWriteMasked)
+        {
+            sseByteWriteMask = _mm_and_si128(sseByteWriteMask, _mm_set1_epi32(static_cast<int32_t>(m_pPipelineState->m_ColorWriteByteMask)));
+        }
+
+        uint32_t colorPitch;
+        uint8_t* pColorBufferAddress = GetColorBufferAddress(sampleX, sampleY, &colorPitch);
 
-        // Mask-store 4-sample fragment values
-        _mm_maskmoveu_si128(
-            sseFragmentOut,
-            _mm_castps_si128(sseWriteMask),
-            reinterpret_cast<char*>(pColorBufferAddress));
+        if constexpr (g_scIsSampleGroupContiguous)
+        {
+            // Merge with current contents and store SIMD group at once
+            __m128i* pColorGroup = reinterpret_cast<__m128i*>(pColorBufferAddress);
+            _mm_store_si128(pColorGroup, _mm_blendv_epi8(_mm_load_si128(pColorGroup), sseFragmentOut, sseByteWriteMask));
+        }
+        else if constexpr (g_scSampleLayout == SampleLayout::QUAD_2x2)
+        {
+            // Quad spans two rows, so merge with current contents and store two samples per row
+            __m128i sseColorCurrent = _mm_unpacklo_epi64(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pColorBufferAddress)),
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pColorBufferAddress + colorPitch)));
+
+            __m128i sseColorMerged = _mm_blendv_epi8(sseColorCurrent, sseFragmentOut, sseByteWriteMask);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pColorBufferAddress), sseColorMerged);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(pColorBufferAddress + colorPitch), _mm_unpackhi_epi64(sseColorMerged, sseColorMerged));
+        }
+        else
+        {
+            // Mask-store 4-sample fragment values
+            _mm_maskmoveu_si128(
+                sseFragmentOut,
+                sseByteWriteMask,
+                reinterpret_cast<char*>(pColorBufferAddress));
+        }
+    }
+
+    template<bool IsColorWriteMasked>
+    void RenderEngine::UpdateColorBuffer(const __m128& sseFragmentColor, uint32_t sampleX, uint32_t sampleY)
+    {
+        // rgba = cast<uint>(rgba * 255.f)
+        __m128i sseSample = _mm_cvtps_epi32(_mm_mul_ps(sseFragmentColor, _mm_set1_ps(255.f)));
+
+        // Pack down to 8 bits
+        sseSample = _mm_packus_epi32(sseSample, sseSample);
+        sseSample = _mm_packus_epi16(sseSample, sseSample);
+
+        uint32_t colorPitch;
+        uint8_t* pColorBufferAddress = GetColorBufferAddress(sampleX, sampleY, &colorPitch);
+
+        uint32_t* pColor = reinterpret_cast<uint32_t*>(pColorBufferAddress);
+
+        if constexpr (IsColorWriteMasked)
+        {
+            const uint32_t colorWriteMask = m_pPipelineState->m_ColorWriteByteMask;
+            *pColor = (*pColor & ~colorWriteMask) | (static_cast<uint32_t>(_mm_cvtsi128_si32(sseSample)) & colorWriteMask);
+        }
+        else
+        {
+            *pColor = static_cast<uint32_t>(_mm_cvtsi128_si32(sseSample));
+        }
+    }
+
+    // Both variants are used by fragment stages instantiated in ShaderPipeline.h
+    template void RenderEngine::UpdateColorBuffer<false>(const __m128&, const FragmentOutput&, uint32_t, uint32_t);
+    template void RenderEngine::UpdateColorBuffer<true>(const __m128&, const FragmentOutput&, uint32_t, uint32_t);
+    template void RenderEngine::UpdateColorBuffer<false>(const __m128&, uint32_t, uint32_t);
+    template void RenderEngine::UpdateColorBuffer<true>(const __m128&, uint32_t, uint32_t);
+    template void RenderEngine::UpdateColorBufferRGBA8<false>(const __m128&, const __m128i&, uint32_t, uint32_t);
+    template void RenderEngine::UpdateColorBufferRGBA8<true>(const __m128&, const __m128i&, uint32_t, uint32_t);
+
+    void RenderEngine::BakePipelineState(const PipelineStateDesc& desc, PipelineState* pState)
+    {
+        ASSERT(pState != nullptr);
+        ASSERT(desc.m_DepthFunc < DepthFunc::COUNT);
+        ASSERT(desc.m_CullMode < CullMode::COUNT);
+        ASSERT(desc.m_FrontFace < FrontFace::COUNT);
+        ASSERT((desc.m_ColorWriteMask & ~g_scColorWriteAll) == 0);
+
+        pState->m_Desc = desc;
+
+        // Map cull mode to triangle winding
+        const bool cullFront = (desc.m_CullMode == CullMode::FRONT);
+        const bool cullBack = (desc.m_CullMode == CullMode::BACK);
+        const bool isFrontCCW = (desc.m_FrontFace == FrontFace::COUNTER_CLOCKWISE);
+
+        pState->m_CullCounterClockwise = isFrontCCW ? cullFront : cullBack;
+        pState->m_CullClockwise = isFrontCCW ? cullBack : cullFront;
+
+        // Expand RGBA bits to RGBA8 byte mask
+        pState->m_ColorWriteByteMask =
+            ((desc.m_ColorWriteMask & g_scColorWriteR) ? 0x000000FFu : 0u) |
+            ((desc.m_ColorWriteMask & g_scColorWriteG) ? 0x0000FF00u : 0u) |
+            ((desc.m_ColorWriteMask & g_scColorWriteB) ? 0x00FF0000u : 0u) |
+            ((desc.m_ColorWriteMask & g_scColorWriteA) ? 0xFF000000u : 0u);
+
+        const ColorWriteMode colorWriteMode =
+            (desc.m_ColorWriteMask == 0) ? ColorWriteMode::NONE :
+            (desc.m_ColorWriteMask == g_scColorWriteAll) ? ColorWriteMode::ALL : ColorWriteMode::MASKED;
+
+        pState->m_FragmentStageVariant = GetFragmentStageVariant(desc.m_DepthFunc, desc.m_DepthWriteEnabled, colorWriteMode);
+
+        // Only the nearest (or farthest) sample is kept regardless of order with strict depth tests, given that every sample passing it is written
+        pState->m_IsOrderIndependent = desc.m_OrderIndependent && desc.m_DepthWriteEnabled &&
+            ((desc.m_DepthFunc == DepthFunc::LESS) || (desc.m_DepthFunc == DepthFunc::GREATER));
     }
 }
\ No newline at end of file
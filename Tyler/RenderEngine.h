@@ -4,18 +4,20 @@
 #include "RenderState.h"
 #include "TileQueue.h"
 #include "CoverageMaskBuffer.h"
+#include "WaitEvent.h"
 
 namespace tyler
 {
     struct PipelineThread;
+    struct ShaderPipeline;
 
     struct TriangleSetupBuffers
     {
         // Coefficients of three edge equations
         glm::vec3*  m_pEdgeCoefficients;
 
-        // Interpolated z coordinates of three vertices
-        glm::vec3*  m_pInterpolatedZValues;
+        // Coefficients of screen-space Z/W plane equation Z(x, y) = (a * x) + (b * y) + c
+        glm::vec3*  m_pDepthPlaneCoefficients;
 
         // Interpolation deltas computed after VS that'll be used for perspective-correct interpolation of vertex attributes
         glm::vec3*  m_Attribute4Deltas[g_scMaxVertexAttributes];
@@ -26,13 +28,76 @@ namespace tyler
         Rect2D*     m_pPrimBBoxes;
     };
 
+    // Data produced by geometry processing of a draw iteration and consumed by its rasterization & fragment shading
+    // There are g_scMaxDrawIterationsInFlight of them, used in turn by consecutive draw iterations
+    struct DrawIteration
+    {
+        // SoA for all data required for TriangleSetup
+        TriangleSetupBuffers                            m_SetupBuffers;
+
+        // FIFO of tiles waiting to be rasterized
+        TileQueue                                       m_RasterizerQueue;
+
+        // Array of per-tile bins which contain indices of primitives that intersect a tile
+        std::vector<std::vector<std::vector<uint32_t>>> m_BinList;
+
+        // Per-thread array of tile coverage masks emitted by rasterizers concurrently
+        std::vector<std::vector<CoverageMaskBuffer*>>   m_CoverageMasks;
+
+        // Per-thread flags of whether bins & coverage mask buffers of the thread are allocated for current tiles, see PipelineThread::AllocateTileStorage()
+        std::vector<uint8_t>                            m_IsThreadTileStorageAllocated;
+
+        // Per-tile state of the draw iteration
+        std::vector<TileIterationState>                 m_TileStates;
+
+        // Offset of next batch of primitives of the draw iteration to be fetched for geometry processing, see g_scDynamicGeometryDistributionEnabled
+        std::atomic<uint32_t>                           m_NextGeometryBatchOffset { 0u };
+
+        // # PipelineThreads that completed binning primitives of the draw iteration
+        std::atomic<uint32_t>                           m_NumThreadsBinned { 0u };
+
+        // Set by the last PipelineThread to complete binning once queued tiles are ready to be fetched
+        std::atomic<bool>                               m_IsBinningComplete { false };
+
+        // When the draw iteration was handed over to PipelineThreads, see g_scWakeUpStatsEnabled
+        std::chrono::steady_clock::time_point           m_DispatchTime;
+    };
+
     struct RenderEngine
     {
         RenderEngine(const RasterizerConfig& renderConfig);
         ~RenderEngine();
 
-        // Fully clear bound color and depth buffers before starting a render pass
-        void ClearRenderTargets(bool clearColor, const glm::vec4& colorValue, bool clearDepth, float depthValue);
+        // Apply load actions of bound color and depth buffers when starting a render pass, clears only record clear values and per-tile fast clear flags if tile buffers are enabled
+        void BeginRenderPass(const RenderPassDesc& desc);
+
+        // Depth contents never leave tile buffers in current render pass, so no depth buffer needs to be bound
+        bool IsDepthTransient() const
+        {
+            return g_scTileBuffersEnabled && (m_RenderPassDesc.m_DepthLoadOp != LoadOp::LOAD) && (m_RenderPassDesc.m_DepthStoreOp == StoreOp::DONT_CARE);
+        }
+
+        // Load (or clear) tile buffers of the tile before it's fragment-shaded for the first time in a render pass
+        void LoadTileBuffers(uint32_t tileIdx);
+
+        // Load tile buffers of the tile to be fragment-shaded in the draw iteration, only once if its work items are fragment-shaded concurrently
+        void LoadTileBuffersForFragmentShading(DrawIteration* pDrawIteration, uint32_t tileIdx);
+
+        // Write contents of all tile buffers to framebuffer in parallel as requested by store actions of current render pass, ending it
+        // Fast clears (g_scFastClear*) of tiles that weren't drawn to are written as well if included in fastClearsToResolve, otherwise they're kept
+        void ResolveTileBuffers(uint8_t fastClearsToResolve = g_scFastClearAll);
+
+        // Write contents of tile buffers (or fast clear values) of a single tile to framebuffer
+        void ResolveTile(uint32_t tileIdx, uint8_t fastClearsToResolve);
+
+        // Stall callee until all PipelineThreads complete resolving tiles
+        void WaitForPipelineThreadsToCompleteResolve();
+
+        // Fast clear flags of the tile containing given pixel
+        uint8_t GetFastClearFlags(uint32_t x, uint32_t y) const
+        {
+            return m_FastClearFlags[GetGlobalTileIndex(x >> m_TileSizeLog2, y >> m_TileSizeLog2)];
+        }
 
         // Bind active framebuffer and allocate RT-dependent data, if necessary (e.g. RT resolution change, NULL RT, etc.)
         void SetRenderTargets(Framebuffer* pFramebuffer);
@@ -42,16 +107,66 @@ namespace tyler
 
         // Perform necessary state/data invalidations for drawcalls and draw iterations
         void ApplyPreDrawcallStateInvalidations();
-        void ApplyPreDrawIterationStateInvalidations();
+        void ApplyPreDrawIterationStateInvalidations(DrawIteration* pDrawIteration);
+
+        // Stall callee until no PipelineThread has more than given # draw iterations dispatched to it left to process
+        void WaitForPipelineThreadsToCompleteDrawIterations(uint32_t maxNumIterationsInFlight);
+
+        // Stall PipelineThreads until all of them complete binning primitives of the draw iteration to their respective tiles
+        void WaitForPipelineThreadsToCompleteBinning(DrawIteration* pDrawIteration);
+
+        // Release PipelineThreads stalled at the post-binning sync point, which is done by the last thread to complete binning
+        void SignalBinningComplete(DrawIteration* pDrawIteration);
+
+        // Reorder tiles queued in the draw iteration by their position on screen, see g_scTileDispatchOrder (unless scheduled by cost, which applies it per cost class)
+        void ScheduleQueuedTilesByDispatchOrder(DrawIteration* pDrawIteration);
+
+        // Position of the tile at given tile coordinates in g_scTileDispatchOrder
+        uint32_t ComputeTileDispatchOrder(uint32_t tileX, uint32_t tileY) const;
+
+        // Reorder tiles queued in the draw iteration so that the ones with the highest estimated cost are rasterized/fragment-shaded first,
+        // and ones of similar cost in g_scTileDispatchOrder
+        // Heavy tiles are split into sub-tiles queued separately, see g_scTileSplittingEnabled
+        void ScheduleQueuedTilesByCost(DrawIteration* pDrawIteration);
+
+        // Replace tiles queued in an order-independent draw iteration with per-thread bins of them, so that they can be processed by separate threads concurrently
+        void SplitQueuedTilesByThreadBins(DrawIteration* pDrawIteration);
+
+        // Serialize fragment shading of the 8x8 block at given sample position in order-independent drawcalls, see g_scNumBlockLocks
+        void LockBlock(uint32_t sampleX, uint32_t sampleY)
+        {
+            std::atomic_flag& blockLock = m_BlockLocks[GetBlockLockIndex(sampleX, sampleY)];
+            while (blockLock.test_and_set(std::memory_order_acquire))
+            {
+                _mm_pause();
+            }
+        }
+
+        void UnlockBlock(uint32_t sampleX, uint32_t sampleY)
+        {
+            m_BlockLocks[GetBlockLockIndex(sampleX, sampleY)].clear(std::memory_order_release);
+        }
+
+        uint32_t GetBlockLockIndex(uint32_t sampleX, uint32_t sampleY) const
+        {
+            return ((sampleX / g_scPixelBlockSize) + (sampleY / g_scPixelBlockSize) * m_NumBlockPerRow) % g_scNumBlockLocks;
+        }
+
+        // Mark the tile as rasterized in the draw iteration, which is done by the single thread that rasterized it
+        void SignalTileRasterizationComplete(DrawIteration* pDrawIteration, uint32_t tileIdx);
+
+        // Stall callee until rasterization of the tile is completed in the draw iteration, so that it can be fragment-shaded
+        void WaitForTileToCompleteRasterization(DrawIteration* pDrawIteration, uint32_t tileIdx);
 
-        // Stall callee until all PipelineThreads complete processing of a single drawcall
-        void WaitForPipelineThreadsToCompleteProcessingDrawcall() const;
+        // Mark the tile as fragment-shaded in the draw iteration, which is done by the single thread that fragment-shaded it
+        void SignalTileShadingComplete(DrawIteration* pDrawIteration, uint32_t tileIdx);
 
-        // Stall PipelineThreads until all of them complete binning primitives to their respective tiles
-        void WaitForPipelineThreadsToCompleteBinning() const;
+        // Stall callee until the tile is fragment-shaded in all previous draw iterations that it was queued in
+        void WaitForTileToCompleteShadingOfPreviousIterations(DrawIteration* pDrawIteration, uint32_t tileIdx);
 
-        // Stall PipelineThreads until all of them complete rasterization
-        void WaitForPipelineThreadsToCompleteRasterization() const;
+        // Accumulated wake-up stats of all PipelineThreads since last reset
+        void GetThreadWakeUpStats(ThreadWakeUpStats* pStats) const;
+        void ResetThreadWakeUpStats();
 
         // Return a tile's global index given its row/column address
         uint32_t GetGlobalTileIndex(uint32_t tileX, uint32_t tileY) const
@@ -59,45 +174,133 @@ namespace tyler
             return (tileX + tileY * m_NumTilePerRow);
         }
 
-        // Return next available tile index to be rasterized from tile queue
-        uint32_t FetchNextTileForRasterization()
+        // Tile & work item indices of a tile queue entry
+        static uint32_t GetQueuedTileIndex(uint32_t queueEntry)
         {
-            return m_RasterizerQueue.FetchNextTileIndex();
+            return (queueEntry & g_scTileIndexMask);
         }
 
-        // Return next available tile index to be fragment-shaded from tile queue
-        uint32_t FetchNextTileForFragmentShading()
+        static uint32_t GetQueuedWorkItemIndex(uint32_t queueEntry)
         {
-            return m_RasterizerQueue.RemoveTileIndex();
+            return (queueEntry >> g_scWorkItemIndexShift);
+        }
+
+        // Return next available tile index to be rasterized from tile queue (with work item index, see GetQueuedWorkItemIndex())
+        uint32_t FetchNextTileForRasterization(DrawIteration* pDrawIteration)
+        {
+            return pDrawIteration->m_RasterizerQueue.FetchNextTileIndex();
+        }
+
+        // Return next available tile index to be fragment-shaded from tile queue (with work item index, see GetQueuedWorkItemIndex())
+        uint32_t FetchNextTileForFragmentShading(DrawIteration* pDrawIteration)
+        {
+            return pDrawIteration->m_RasterizerQueue.RemoveTileIndex();
         }
 
         // Add the tile to the rasterizer queue iff it's not done yet
-        void EnqueueTileForRasterization(uint32_t tileIdx);
+        void EnqueueTileForRasterization(DrawIteration* pDrawIteration, uint32_t tileIdx);
 
         // Bin a primitive to thread-local bin of a tile
-        void BinPrimitiveForTile(uint32_t threadIdx, uint32_t tileIdx, uint32_t primIdx);
+        void BinPrimitiveForTile(DrawIteration* pDrawIteration, uint32_t threadIdx, uint32_t tileIdx, uint32_t primIdx);
 
         // Append tile, block or fragment coverage mask
-        void AppendCoverageMask(uint32_t threadIdx, uint32_t tileIdx, const CoverageMask& mask);
+        void AppendCoverageMask(DrawIteration* pDrawIteration, uint32_t threadIdx, uint32_t tileIdx, const CoverageMask& mask);
 
-        // Check and grow mask buffers if needed
-        void ResizeCoverageMaskBuffer(uint32_t threadIdx, uint32_t tileIdx);
+        // Address of given sample in the depth/color buffer that the fragment stage works on, along with row pitch (in floats for depth, bytes for color)
+        // That is the tile buffer of the tile sample falls into, if enabled
+        float* GetDepthBufferAddress(uint32_t sampleX, uint32_t sampleY, uint32_t* pPitch) const
+        {
+            if constexpr (g_scTileBuffersEnabled)
+            {
+                *pPitch = m_RenderConfig.m_TileSize;
+                return &m_pTileDepthBuffers[GetTileBufferOffset(sampleX, sampleY)];
+            }
+            else
+            {
+                *pPitch = m_Framebuffer.m_Width;
+                return &m_Framebuffer.m_pDepthBuffer[sampleX + sampleY * m_Framebuffer.m_Width];
+            }
+        }
+
+        uint8_t* GetColorBufferAddress(uint32_t sampleX, uint32_t sampleY, uint32_t* pPitch) const
+        {
+            if constexpr (g_scTileBuffersEnabled)
+            {
+                *pPitch = m_RenderConfig.m_TileSize * 4;
+                return &m_pTileColorBuffers[4 * GetTileBufferOffset(sampleX, sampleY)];
+            }
+            else
+            {
+                *pPitch = m_Framebuffer.m_Width * 4;
+                return &m_Framebuffer.m_pColorBuffer[4 * (sampleX + sampleY * m_Framebuffer.m_Width)];
+            }
+        }
+
+        // Offset of given sample in tile buffers (in # of samples), where all samples of a tile are stored contiguously (see g_scTileBufferLayout)
+        uint32_t GetTileBufferOffset(uint32_t sampleX, uint32_t sampleY) const
+        {
+            const uint32_t tileIdx = GetGlobalTileIndex(sampleX >> m_TileSizeLog2, sampleY >> m_TileSizeLog2);
+            const uint32_t tileMask = m_RenderConfig.m_TileSize - 1;
+
+            const uint32_t x = sampleX & tileMask;
+            const uint32_t y = sampleY & tileMask;
+
+            if constexpr (g_scTileBufferLayout == TileBufferLayout::BLOCK_SWIZZLED)
+            {
+                // 8x8 blocks of the tile in row-major order
+                const uint32_t blockIdx = (x / g_scPixelBlockSize) + (y / g_scPixelBlockSize) * (m_RenderConfig.m_TileSize / g_scPixelBlockSize);
+
+                return (tileIdx << (2 * m_TileSizeLog2)) + blockIdx * g_scNumSamplesPerBlock +
+                    GetSwizzledBlockSampleOffset(x % g_scPixelBlockSize, y % g_scPixelBlockSize);
+            }
+            else
+            {
+                return (tileIdx << (2 * m_TileSizeLog2)) + x + (y << m_TileSizeLog2);
+            }
+        }
 
         // Write interpolated Z values to depth buffer based on write mask at given sample
         void UpdateDepthBuffer(const __m128& sseWriteMask, const __m128& sseDepthValues, uint32_t sampleX, uint32_t sampleY);
 
+        // Write Z values of all samples of the SIMD group at given sample, e.g. when they were merged with current contents already
+        void StoreDepthBuffer(const __m128& sseDepthValues, uint32_t sampleX, uint32_t sampleY);
+
         // Fetch depth buffer contents at given sample
         __m128 FetchDepthBuffer(uint32_t sampleX, uint32_t sampleY) const;
 
+        // Fetch color buffer contents of the SIMD group at given sample, converted to R32G32B32A32_FLOAT
+        void FetchColorBuffer(uint32_t sampleX, uint32_t sampleY, __m128* pSSEColors) const;
+
+        // Fetch/update max depth value of the 8x8 block that given sample falls into
+        float FetchHiZValue(uint32_t sampleX, uint32_t sampleY) const;
+        void UpdateHiZValue(float maxDepth, uint32_t sampleX, uint32_t sampleY);
+
         // Write shaded fragment output to color buffer based on write mask at given sample
+        // If IsColorWriteMasked, only color channels enabled in bound pipeline state are written
+        template<bool IsColorWriteMasked>
         void UpdateColorBuffer(const __m128& sseWriteMask, const FragmentOutput& fragmentOutput, uint32_t sampleX, uint32_t sampleY);
 
+        // Same as above with 4-sample colors already converted to R8G8B8A8_UNORM (e.g. to fill samples with a constant color)
+        template<bool IsColorWriteMasked>
+        void UpdateColorBufferRGBA8(const __m128& sseWriteMask, const __m128i& sseFragmentOut, uint32_t sampleX, uint32_t sampleY);
+
+        // Write a single shaded fragment to color buffer at given sample
+        template<bool IsColorWriteMasked>
+        void UpdateColorBuffer(const __m128& sseFragmentColor, uint32_t sampleX, uint32_t sampleY);
+
+        // Validate fixed-function state and set up derived data (e.g. fragment stage variant)
+        static void BakePipelineState(const PipelineStateDesc& desc, PipelineState* pState);
+
         // Global rendering parameters
         const RasterizerConfig&                         m_RenderConfig;
 
         // Active frame buffer configuration
         Framebuffer                                     m_Framebuffer;
 
+        // Load/store actions of current render pass, which is active until tile buffers are resolved
+        RenderPassDesc                                  m_RenderPassDesc;
+        bool                                            m_IsRenderPassActive = false;
+
         // Bound vertex buffer
         VertexBuffer*                                   m_pVertexBuffer = nullptr;
         // Vertex input stride in bytes
@@ -106,35 +309,92 @@ namespace tyler
         // Bound index buffer
         IndexBuffer*                                    m_pIndexBuffer = nullptr;
 
-        // SoA for all data required for TriangleSetup
-        TriangleSetupBuffers                            m_SetupBuffers;
+        // Per-draw iteration data, draw iteration N uses m_DrawIterations[N % g_scMaxDrawIterationsInFlight]
+        DrawIteration                                   m_DrawIterations[g_scMaxDrawIterationsInFlight];
+
+        // # draw iterations dispatched to PipelineThreads so far, each of which is processed by all PipelineThreads
+        std::atomic<uint32_t>                           m_NumDispatchedIterations;
 
         // Bound Vertex & Fragment shader function pointers that will be invoked
         VertexShader                                    m_VertexShader = nullptr;
         FragmentShader                                  m_FragmentShader = nullptr;
+        BlockFragmentShader                             m_BlockFragmentShader = nullptr;
+        TileShader                                      m_TileShader = nullptr;
         ConstantBuffer*                                 m_pConstantBuffer = nullptr;
         ShaderMetadata                                  m_ShaderMetadata;
 
+        // Shader pipeline to be used by drawcalls, either a typed one or the one invoking bound shader function pointers
+        const ShaderPipeline*                           m_pShaderPipeline = nullptr;
+        ShaderPipeline*                                 m_pDynamicShaderPipeline = nullptr;
+
+        // Bound fixed-function state, which defaults to LESS_EQUAL depth test with depth & color writes and back-face culling
+        const PipelineState*                            m_pPipelineState = nullptr;
+        PipelineState                                   m_DefaultPipelineState;
+
+        // Per-drawcall state resolved from bound shaders, RTs and pipeline state
+        // Drawcalls are depth-only if there's no FS or no color to write, in which case the fragment stage variant without color writes is used
+        bool                                            m_IsDepthOnly = false;
+        uint32_t                                        m_FragmentStageVariant = 0u;
+
+        // Tiles of the drawcall are fragment-shaded by multiple threads at a time, see PipelineStateDesc::m_OrderIndependent
+        bool                                            m_IsOrderIndependent = false;
+
+        // Striped locks of 8x8 blocks fragment-shaded in order-independent drawcalls
+        std::atomic_flag                                m_BlockLocks[g_scNumBlockLocks];
+
         // PipelineThreads will run concurrently to implement the pipeline stages
         std::vector<PipelineThread*>                    m_PipelineThreads;
 
-        // Used to synchronize for all threads to enter the pipeline at the same time
-        std::atomic<bool>                               m_DrawcallSetupComplete;
+        // Signaled when a PipelineThread reaches a sync point, which PipelineThreads wait on for each other
+        WaitEvent                                       m_SyncPointEvent;
 
-        // Array of tiles that'll be allocated based on screen resolution and fixed tile size
-        std::vector<Tile>                               m_TileList;
+        // Signaled when rasterization of a tile is completed, which PipelineThreads wait on to fragment-shade the tile
+        WaitEvent                                       m_TileRasterizationEvent;
 
-        // FIFO of tiles waiting to be rasterized
-        TileQueue                                       m_RasterizerQueue;
+        // Signaled when fragment shading of a tile is completed, which PipelineThreads wait on to fragment-shade the tile in next draw iteration
+        WaitEvent                                       m_TileShadingEvent;
 
-        // Array of per-tile bins which contain indices of primitives that intersect a tile
-        std::vector<std::vector<std::vector<uint32_t>>> m_BinList;
+        // Signaled when a PipelineThread completes a draw iteration or tile resolve, which the main thread waits on
+        WaitEvent                                       m_ThreadCompletionEvent;
 
-        // Per-thread array of tile coverage masks emitted by rasterizers concurrently
-        std::vector<std::vector<CoverageMaskBuffer*>>   m_CoverageMasks;
+        // When last tile resolve was handed over to PipelineThreads, see g_scWakeUpStatsEnabled
+        std::chrono::steady_clock::time_point           m_DispatchTime;
+
+        // Array of tiles that'll be allocated based on screen resolution and fixed tile size
+        std::vector<Tile>                               m_TileList;
+
+        // Per-block max depth values of the depth buffer, which are kept conservative (i.e. >= actual depth values within block)
+        std::vector<float>                              m_HiZBuffer;
 
         // Number of tiles per row/column
         uint32_t                                        m_NumTilePerRow = 0u;
         uint32_t                                        m_NumTilePerColumn = 0u;
+
+        // Number of 8x8 blocks per row
+        uint32_t                                        m_NumBlockPerRow = 0u;
+
+        // log2(tile size), tile sizes are powers of two
+        uint32_t                                        m_TileSizeLog2 = 0u;
+
+        // Tile-sized color (R8G8B8A8_UNORM) & depth (D32_FLOAT) buffers of all tiles, each of which is only accessed by the thread fragment-shading the tile
+        uint8_t*                                        m_pTileColorBuffers = nullptr;
+        float*                                          m_pTileDepthBuffers = nullptr;
+
+        // Per-tile flag set if tile buffers hold the tile's contents in current render pass (uint8_t rather than bool so that threads don't share bits)
+        std::vector<uint8_t>                            m_IsTileBufferLoaded;
+
+        // Per-tile g_scFastClear* flags of RTs whose clear value hasn't been written to tile buffers or framebuffer yet
+        std::vector<uint8_t>                            m_FastClearFlags;
+
+        // Clear values of the last clear, packed as R8G8B8A8_UNORM for color
+        uint32_t                                        m_ColorClearValue = 0u;
+        float                                           m_DepthClearValue = 0.f;
+
+        // Next tile to be resolved by PipelineThreads and fast clears to be resolved along with it
+        std::atomic<uint32_t>                           m_NextTileToResolve;
+        uint8_t                                         m_FastClearsToResolve = g_scFastClearAll;
+
+        // Tile shader is only invoked when resolving tiles ends a render pass
+        bool                                            m_IsTileShaderEnabled = false;
     };
 }
\ No newline at end of file
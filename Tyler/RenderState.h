@@ -1,5 +1,7 @@
 #pragma once
 
+#include "RasterizerConfig.h"
+
 namespace tyler
 {
     using IndexType = uint32_t;
@@ -18,6 +20,12 @@ namespace tyler
         uint32_t    m_Height = 0u;
     };
 
+    // Per-tile fast clear metadata: clears only record clear values and flag all tiles, so RTs of a tile
+    // are initialized with the clear value when it's first drawn to, or written to framebuffer when render pass ends
+    static constexpr uint8_t    g_scFastClearColor = 0x1;
+    static constexpr uint8_t    g_scFastClearDepth = 0x2;
+    static constexpr uint8_t    g_scFastClearAll = g_scFastClearColor | g_scFastClearDepth;
+
     using ConstantBuffer = void;
 
     // Max number of vertex attributes that can be passed to FS after interpolation
@@ -30,10 +38,33 @@ namespace tyler
         glm::vec2   m_Attributes2[g_scMaxVertexAttributes];
     };
 
-    // Packed group of attributes for 4 consecutive samples
+    // Packed group of attributes for 4 samples of a SIMD group (see g_scSampleLayout)
     // that will be interpolated w/ SSE and passed onto FS
     struct InterpolatedAttributes
     {
+        // Screen-space derivatives of interpolated values across the SIMD group, one per lane (i.e. fine derivatives).
+        // Uncovered and depth-failed lanes are interpolated as well, so derivatives are valid for partially covered groups too,
+        // unless FS is declared with g_scShaderHintNoDerivatives, whose fragments may be packed into SIMD groups of unrelated samples
+
+        // d/dx: lanes (0, 1) and (2, 3) are horizontal neighbors in both layouts
+        static __m128 DDX(const __m128& sseValues)
+        {
+            return _mm_sub_ps(
+                _mm_shuffle_ps(sseValues, sseValues, _MM_SHUFFLE(3, 3, 1, 1)),
+                _mm_shuffle_ps(sseValues, sseValues, _MM_SHUFFLE(2, 2, 0, 0)));
+        }
+
+        // d/dy: lanes (0, 2) and (1, 3) are vertical neighbors, only in 2x2 quad layout
+        template<SampleLayout Layout = g_scSampleLayout>
+        static __m128 DDY(const __m128& sseValues)
+        {
+            static_assert(Layout == SampleLayout::QUAD_2x2, "DDY requires SampleLayout::QUAD_2x2");
+
+            return _mm_sub_ps(
+                _mm_shuffle_ps(sseValues, sseValues, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm_shuffle_ps(sseValues, sseValues, _MM_SHUFFLE(1, 0, 1, 0)));
+        }
+
         struct Vec4Attributes
         {
             union { glm::vec4 m_VecX; __m128 m_SSEX; };
@@ -58,8 +89,56 @@ namespace tyler
         Vec4Attributes  m_Vec4Attributes[g_scMaxVertexAttributes];
         Vec3Attributes  m_Vec3Attributes[g_scMaxVertexAttributes];
         Vec2Attributes  m_Vec2Attributes[g_scMaxVertexAttributes];
+
+        // Subpass inputs, i.e. color (R32G32B32A32_FLOAT, one per lane as in FragmentOutput) & depth values of the samples
+        // as written by previous drawcalls (subpasses) of the render pass, before the current primitive. Only set if FS reads them (see g_scShaderHintSubpassInput)
+        __m128          m_SubpassInputColors[4];
+        __m128          m_SubpassInputDepth;
     };
 
+    // SoA attributes of all samples in an 8x8 block that will be passed onto block FS.
+    // Sample i is the lane (i % 4) of SIMD group (i / 4), where SIMD groups are in row-major order within the block,
+    // so loading 4 consecutive values of a channel yields the same lane layout as InterpolatedAttributes.
+    struct BlockInterpolatedAttributes
+    {
+        struct Vec4Attributes
+        {
+            alignas(16) float   m_X[g_scNumSamplesPerBlock];
+            alignas(16) float   m_Y[g_scNumSamplesPerBlock];
+            alignas(16) float   m_Z[g_scNumSamplesPerBlock];
+            alignas(16) float   m_W[g_scNumSamplesPerBlock];
+        };
+
+        struct Vec3Attributes
+        {
+            alignas(16) float   m_X[g_scNumSamplesPerBlock];
+            alignas(16) float   m_Y[g_scNumSamplesPerBlock];
+            alignas(16) float   m_Z[g_scNumSamplesPerBlock];
+        };
+
+        struct Vec2Attributes
+        {
+            alignas(16) float   m_X[g_scNumSamplesPerBlock];
+            alignas(16) float   m_Y[g_scNumSamplesPerBlock];
+        };
+
+        Vec4Attributes  m_Vec4Attributes[g_scMaxVertexAttributes];
+        Vec3Attributes  m_Vec3Attributes[g_scMaxVertexAttributes];
+        Vec2Attributes  m_Vec2Attributes[g_scMaxVertexAttributes];
+    };
+
+    // Hints about FS behavior which let the fragment stage skip work, to be combined in ShaderMetadata::m_ShaderHints
+    // FS doesn't take screen-space derivatives (DDX/DDY) of its inputs, so live fragments of partially covered SIMD groups
+    // can be packed into full SIMD groups before FS is invoked (see g_scFragmentPackingEnabled)
+    static constexpr uint8_t    g_scShaderHintNoDerivatives = 0x1;
+    // FS output doesn't vary across fragments of a primitive (e.g. solid colors, object IDs), so FS is invoked once per primitive
+    static constexpr uint8_t    g_scShaderHintConstantOutput = 0x2;
+    // FS doesn't read any interpolated attributes (even if VS writes them), so they're neither set up nor interpolated
+    static constexpr uint8_t    g_scShaderHintNoAttributes = 0x4;
+    // FS reads subpass inputs (color & depth at its own samples, see InterpolatedAttributes), e.g. a lighting pass reading a G-buffer pass's output
+    // from tile buffers without a round trip through framebuffer. Neither a block FS nor g_scShaderHintConstantOutput may be used along with it
+    static constexpr uint8_t    g_scShaderHintSubpassInput = 0x8;
+
     // VS/FS related shader metadata
     struct ShaderMetadata
     {
@@ -67,16 +146,160 @@ namespace tyler
         uint8_t    m_NumVec4Attributes;
         uint8_t    m_NumVec3Attributes;
         uint8_t    m_NumVec2Attributes;
+
+        // Combination of g_scShaderHint* flags
+        uint8_t    m_ShaderHints = 0u;
     };
 
-    // 4-sample fragment output
+    // 4-sample fragment output, in the same lane order as InterpolatedAttributes
     struct FragmentOutput
     {
         // R32G32B32A32_FLOAT x 4
         __m128  m_FragmentColors[4];
     };
 
+    // 64-sample SoA fragment output, in the same sample order as BlockInterpolatedAttributes
+    struct BlockFragmentOutput
+    {
+        // R32G32B32A32_FLOAT x 64
+        alignas(16) float   m_R[g_scNumSamplesPerBlock];
+        alignas(16) float   m_G[g_scNumSamplesPerBlock];
+        alignas(16) float   m_B[g_scNumSamplesPerBlock];
+        alignas(16) float   m_A[g_scNumSamplesPerBlock];
+    };
+
     // Vertex & Fragment shader definitions
     using VertexShader = glm::vec4(*)(VertexInput* pVertexInput, VertexAttributes* pVertexAttributes, ConstantBuffer* pConstantBuffer);
     using FragmentShader = void(*)(InterpolatedAttributes* pVertexAttributes, ConstantBuffer* pConstantBuffer, FragmentOutput* pFragmentOut);
+
+    // Optional block FS invoked once per 8x8 block; bit i of liveMask is set if sample i is to be written
+    using BlockFragmentShader = void(*)(BlockInterpolatedAttributes* pVertexAttributes, ConstantBuffer* pConstantBuffer, uint64_t liveMask, BlockFragmentOutput* pFragmentOut);
+
+    // Tile buffers of a tile passed to tile shader, whose samples are arranged as given by GetTileSampleOffset()
+    struct TileShaderInput
+    {
+        // m_TileSize x m_TileSize samples each, 64-byte aligned
+        uint8_t*    m_pColor;   // R8G8B8A8_UNORM
+        float*      m_pDepth;   // D32_FLOAT
+
+        uint32_t    m_TileSize;
+
+        // Framebuffer region covered by the tile, samples of the tile outside of it are never written to framebuffer
+        uint32_t    m_PosX;
+        uint32_t    m_PosY;
+        uint32_t    m_Width;
+        uint32_t    m_Height;
+    };
+
+    // Optional tile shader invoked once per tile when render pass ends, right before tile buffers are written to framebuffer (e.g. tone mapping, format conversion)
+    using TileShader = void(*)(TileShaderInput* pTile, ConstantBuffer* pConstantBuffer);
+
+    // Comparison of interpolated Z against depth buffer contents, sample passes if Z <func> depth holds
+    enum class DepthFunc : uint8_t
+    {
+        NEVER,
+        LESS,
+        EQUAL,
+        LESS_EQUAL,
+        GREATER,
+        NOT_EQUAL,
+        GREATER_EQUAL,
+        ALWAYS,
+        COUNT
+    };
+
+    enum class CullMode : uint8_t
+    {
+        NONE,
+        FRONT,
+        BACK,
+        COUNT
+    };
+
+    // Winding order of front-facing triangles as seen in framebuffer, with row 0 at the top
+    enum class FrontFace : uint8_t
+    {
+        COUNTER_CLOCKWISE,
+        CLOCKWISE,
+        COUNT
+    };
+
+    // Color write mask bits
+    static constexpr uint8_t    g_scColorWriteR = 0x1;
+    static constexpr uint8_t    g_scColorWriteG = 0x2;
+    static constexpr uint8_t    g_scColorWriteB = 0x4;
+    static constexpr uint8_t    g_scColorWriteA = 0x8;
+    static constexpr uint8_t    g_scColorWriteAll = 0xF;
+
+    // Fixed-function state to create a PipelineState from
+    struct PipelineStateDesc
+    {
+        DepthFunc   m_DepthFunc = DepthFunc::LESS_EQUAL;
+        bool        m_DepthWriteEnabled = true;
+        uint8_t     m_ColorWriteMask = g_scColorWriteAll;
+        CullMode    m_CullMode = CullMode::BACK;
+        FrontFace   m_FrontFace = FrontFace::COUNTER_CLOCKWISE;
+
+        // Fragments of a drawcall may be depth-tested & written in any order, e.g. opaque geometry whose result doesn't depend on draw order,
+        // so that several threads can fragment-shade a tile concurrently. Only honored for LESS/GREATER depth tests with depth writes enabled
+        // (which commute, except that samples of different primitives at equal depth are resolved in arbitrary order), and FS not reading subpass inputs
+        bool        m_OrderIndependent = false;
+    };
+
+    // Immutable pipeline state, which is validated once at creation and mapped to a fragment stage variant specialized for it
+    struct PipelineState
+    {
+        PipelineStateDesc   m_Desc;
+
+        // Triangles with det(M) > 0 are counter-clockwise, see ExecuteTriangleSetupAndCull()
+        bool                m_CullCounterClockwise;
+        bool                m_CullClockwise;
+
+        // RGBA8 byte mask of color channels to be written
+        uint32_t            m_ColorWriteByteMask;
+
+        // Order-independent fragment shading is requested and allowed by depth state
+        bool                m_IsOrderIndependent;
+
+        // Index of the pre-instantiated fragment stage variant implementing depth & color write state
+        uint32_t            m_FragmentStageVariant;
+    };
+
+    // What happens to framebuffer contents of an attachment when a render pass begins
+    enum class LoadOp : uint8_t
+    {
+        LOAD,       // Previous contents are preserved
+        CLEAR,      // Contents are cleared to the clear value
+        DONT_CARE   // Previous contents are undefined, so they're never read from framebuffer
+    };
+
+    // What happens to rendered contents of an attachment when a render pass ends
+    enum class StoreOp : uint8_t
+    {
+        STORE,      // Contents are written to framebuffer
+        DONT_CARE   // Contents are discarded, so they're never written to framebuffer (e.g. depth only used within the render pass)
+    };
+
+    // Load/store actions of color & depth attachments of a render pass
+    struct RenderPassDesc
+    {
+        LoadOp      m_ColorLoadOp = LoadOp::LOAD;
+        StoreOp     m_ColorStoreOp = StoreOp::STORE;
+        glm::vec4   m_ColorClearValue = glm::vec4(0.f);
+
+        LoadOp      m_DepthLoadOp = LoadOp::LOAD;
+        StoreOp     m_DepthStoreOp = StoreOp::STORE;
+        float       m_DepthClearValue = 1.f;
+    };
+
+    // Wake-up latency of PipelineThreads, i.e. time from a draw iteration (or tile resolve) being dispatched until a thread starts working on it
+    struct ThreadWakeUpStats
+    {
+        uint64_t    m_NumWakeUps = 0u;
+        double      m_AvgLatencyUs = 0.0;
+        double      m_MaxLatencyUs = 0.0;
+
+        // # waits (thread wake-ups & sync points) which parked the waiting thread after spinning
+        uint64_t    m_NumParks = 0u;
+    };
 }
\ No newline at end of file
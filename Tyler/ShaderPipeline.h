@@ -0,0 +1,203 @@
+#pragma once
+
+#include "RasterizerConfig.h"
+#include "RenderState.h"
+#include "RenderEngine.h"
+#include "PipelineThread.h"
+
+namespace tyler
+{
+    // Compile-time vertex attribute layout of a typed pipeline
+    template<uint8_t NumVec4Attributes, uint8_t NumVec3Attributes, uint8_t NumVec2Attributes>
+    struct AttributeLayout
+    {
+        static_assert(NumVec4Attributes <= g_scMaxVertexAttributes, "Too many vec4 attributes");
+        static_assert(NumVec3Attributes <= g_scMaxVertexAttributes, "Too many vec3 attributes");
+        static_assert(NumVec2Attributes <= g_scMaxVertexAttributes, "Too many vec2 attributes");
+
+        static constexpr uint32_t   s_NumVec4Attributes = NumVec4Attributes;
+        static constexpr uint32_t   s_NumVec3Attributes = NumVec3Attributes;
+        static constexpr uint32_t   s_NumVec2Attributes = NumVec2Attributes;
+    };
+
+    // Shader traits of the function pointer path, i.e. shaders & metadata bound via RenderContext::BindShaders()
+    struct DynamicShaders
+    {
+        static VertexShader GetVertexShader(const RenderEngine* pRenderEngine)
+        {
+            ASSERT(pRenderEngine->m_VertexShader != nullptr);
+            return pRenderEngine->m_VertexShader;
+        }
+
+        static FragmentShader GetFragmentShader(const RenderEngine* pRenderEngine) { return pRenderEngine->m_FragmentShader; }
+        static BlockFragmentShader GetBlockFragmentShader(const RenderEngine* pRenderEngine) { return pRenderEngine->m_BlockFragmentShader; }
+
+        static bool HasFragmentShader(const RenderEngine* pRenderEngine) { return (pRenderEngine->m_FragmentShader != nullptr); }
+        static bool HasBlockFragmentShader(const RenderEngine* pRenderEngine) { return (pRenderEngine->m_BlockFragmentShader != nullptr); }
+
+        static uint32_t NumVec4Attributes(const RenderEngine* pRenderEngine) { return pRenderEngine->m_ShaderMetadata.m_NumVec4Attributes; }
+        static uint32_t NumVec3Attributes(const RenderEngine* pRenderEngine) { return pRenderEngine->m_ShaderMetadata.m_NumVec3Attributes; }
+        static uint32_t NumVec2Attributes(const RenderEngine* pRenderEngine) { return pRenderEngine->m_ShaderMetadata.m_NumVec2Attributes; }
+
+        static bool HasInterpolatedAttributes(const RenderEngine* pRenderEngine)
+        {
+            return (NumVec4Attributes(pRenderEngine) + NumVec3Attributes(pRenderEngine) + NumVec2Attributes(pRenderEngine)) > 0;
+        }
+
+        static bool IsOutputConstantPerPrimitive(const RenderEngine* pRenderEngine) { return (pRenderEngine->m_ShaderMetadata.m_ShaderHints & g_scShaderHintConstantOutput) != 0; }
+        static bool ReadsSubpassInput(const RenderEngine* pRenderEngine) { return (pRenderEngine->m_ShaderMetadata.m_ShaderHints & g_scShaderHintSubpassInput) != 0; }
+        static bool TakesDerivatives(const RenderEngine* pRenderEngine) { return (pRenderEngine->m_ShaderMetadata.m_ShaderHints & g_scShaderHintNoDerivatives) == 0; }
+    };
+
+    // Shader traits of typed pipelines, where VS/FS are stateless functors with the same signatures as VertexShader/FragmentShader
+    // (any state should be passed via ConstantBuffer), attribute counts are given by AttributeLayout and hints by g_scShaderHint* flags
+    template<typename VS, typename FS, typename AttribLayout, uint8_t ShaderHints>
+    struct StaticShaders
+    {
+        static constexpr bool s_IsAttributeSetupEnabled = (ShaderHints & g_scShaderHintNoAttributes) == 0;
+
+        static VS GetVertexShader(const RenderEngine*) { return VS{}; }
+        static FS GetFragmentShader(const RenderEngine*) { return FS{}; }
+        static BlockFragmentShader GetBlockFragmentShader(const RenderEngine*) { return nullptr; }
+
+        static constexpr bool HasFragmentShader(const RenderEngine*) { return true; }
+        static constexpr bool HasBlockFragmentShader(const RenderEngine*) { return false; }
+
+        static constexpr uint32_t NumVec4Attributes(const RenderEngine*) { return s_IsAttributeSetupEnabled ? AttribLayout::s_NumVec4Attributes : 0; }
+        static constexpr uint32_t NumVec3Attributes(const RenderEngine*) { return s_IsAttributeSetupEnabled ? AttribLayout::s_NumVec3Attributes : 0; }
+        static constexpr uint32_t NumVec2Attributes(const RenderEngine*) { return s_IsAttributeSetupEnabled ? AttribLayout::s_NumVec2Attributes : 0; }
+
+        static constexpr bool HasInterpolatedAttributes(const RenderEngine* pRenderEngine)
+        {
+            return (NumVec4Attributes(pRenderEngine) + NumVec3Attributes(pRenderEngine) + NumVec2Attributes(pRenderEngine)) > 0;
+        }
+
+        static constexpr bool IsOutputConstantPerPrimitive(const RenderEngine*) { return (ShaderHints & g_scShaderHintConstantOutput) != 0; }
+        static constexpr bool ReadsSubpassInput(const RenderEngine*) { return (ShaderHints & g_scShaderHintSubpassInput) != 0; }
+        static constexpr bool TakesDerivatives(const RenderEngine*) { return (ShaderHints & g_scShaderHintNoDerivatives) == 0; }
+
+        static_assert(!IsOutputConstantPerPrimitive(nullptr) || !ReadsSubpassInput(nullptr), "FS output can't be constant if FS reads subpass inputs");
+    };
+
+    // How color output is written by a fragment stage variant
+    enum class ColorWriteMode : uint32_t
+    {
+        NONE,       // No color output, so FS isn't invoked at all
+        ALL,        // All RGBA channels are written
+        MASKED,     // Only channels enabled in color write mask are written
+        COUNT
+    };
+
+    // Compile-time depth & color write state of a fragment stage variant
+    template<DepthFunc Func, bool DepthWriteEnabled, ColorWriteMode ColorWrite>
+    struct FixedFunctionState
+    {
+        static constexpr DepthFunc      s_DepthFunc = Func;
+        static constexpr bool           s_DepthWriteEnabled = DepthWriteEnabled;
+        static constexpr ColorWriteMode s_ColorWriteMode = ColorWrite;
+
+        // Depth buffer has to be read only if depth test result depends on it
+        static constexpr bool           s_DepthReadEnabled = (Func != DepthFunc::NEVER) && (Func != DepthFunc::ALWAYS);
+
+        // HiZ keeps per-block max depth, so it can only reject primitives for funcs that never pass with greater Z
+        static constexpr bool           s_HiZRejectionEnabled = g_scHiZEnabled &&
+            ((Func == DepthFunc::LESS) || (Func == DepthFunc::LESS_EQUAL) || (Func == DepthFunc::EQUAL));
+
+        // Partially covered blocks have to raise their HiZ value if depth writes can increase depth
+        static constexpr bool           s_HiZRaiseEnabled = g_scHiZEnabled && DepthWriteEnabled &&
+            ((Func == DepthFunc::GREATER) || (Func == DepthFunc::GREATER_EQUAL) || (Func == DepthFunc::NOT_EQUAL) || (Func == DepthFunc::ALWAYS));
+
+        static constexpr bool           s_FragmentShaderEnabled = (ColorWrite != ColorWriteMode::NONE) && (Func != DepthFunc::NEVER);
+
+        // Neither depth nor color is going to be written
+        static constexpr bool           s_IsNoOp = (Func == DepthFunc::NEVER) || (!DepthWriteEnabled && (ColorWrite == ColorWriteMode::NONE));
+    };
+
+    static constexpr uint32_t g_scNumColorWriteModes = static_cast<uint32_t>(ColorWriteMode::COUNT);
+    static constexpr uint32_t g_scNumFragmentStageVariants = static_cast<uint32_t>(DepthFunc::COUNT) * 2 * g_scNumColorWriteModes;
+
+    // Index of the fragment stage variant implementing given state
+    constexpr uint32_t GetFragmentStageVariant(DepthFunc depthFunc, bool depthWriteEnabled, ColorWriteMode colorWriteMode)
+    {
+        return ((static_cast<uint32_t>(depthFunc) * 2) + (depthWriteEnabled ? 1 : 0)) * g_scNumColorWriteModes + static_cast<uint32_t>(colorWriteMode);
+    }
+
+    // State of the fragment stage variant with given index, inverse of GetFragmentStageVariant()
+    template<uint32_t Variant>
+    using FragmentStageVariantState = FixedFunctionState<
+        static_cast<DepthFunc>(Variant / (2 * g_scNumColorWriteModes)),
+        ((Variant / g_scNumColorWriteModes) % 2) != 0,
+        static_cast<ColorWriteMode>(Variant % g_scNumColorWriteModes)>;
+
+    // Shader traits combined with fixed-function state, which the fragment stage is instantiated with
+    template<typename Shaders, typename State>
+    struct PipelineTraits : public Shaders, public State {};
+
+    // Shader-dependent pipeline stages that PipelineThreads will invoke once per draw iteration
+    struct ShaderPipeline
+    {
+        virtual ~ShaderPipeline() {}
+
+        // Whether any FS entry point is available to produce color output
+        virtual bool HasFragmentShader(const RenderEngine* pRenderEngine) const = 0;
+        virtual bool ReadsSubpassInput(const RenderEngine* pRenderEngine) const = 0;
+
+        // VS + clipper + triangle setup + binner over the primitives assigned to a thread
+        virtual void ExecuteGeometry(PipelineThread* pThread, bool isIndexed, bool isDepthOnly) const = 0;
+
+        // Fragment-shade all tiles a thread fetches from the tile queue, using given fragment stage variant (see PipelineState)
+        virtual void ExecuteFragmentShader(PipelineThread* pThread, uint32_t fragmentStageVariant) const = 0;
+    };
+
+    // Pipeline stages instantiated for given shader traits
+    template<typename Shaders>
+    struct ShaderPipelineImpl final : public ShaderPipeline
+    {
+        bool HasFragmentShader(const RenderEngine* pRenderEngine) const override
+        {
+            return Shaders::HasFragmentShader(pRenderEngine) || Shaders::HasBlockFragmentShader(pRenderEngine);
+        }
+
+        bool ReadsSubpassInput(const RenderEngine* pRenderEngine) const override
+        {
+            return Shaders::ReadsSubpassInput(pRenderEngine);
+        }
+
+        void ExecuteGeometry(PipelineThread* pThread, bool isIndexed, bool isDepthOnly) const override
+        {
+            if (isIndexed)
+            {
+                isDepthOnly ? pThread->ExecuteGeometry<Shaders, true, true>() : pThread->ExecuteGeometry<Shaders, true, false>();
+            }
+            else
+            {
+                isDepthOnly ? pThread->ExecuteGeometry<Shaders, false, true>() : pThread->ExecuteGeometry<Shaders, false, false>();
+            }
+        }
+
+        void ExecuteFragmentShader(PipelineThread* pThread, uint32_t fragmentStageVariant) const override
+        {
+            ASSERT(fragmentStageVariant < g_scNumFragmentStageVariants);
+            (pThread->*s_FragmentStageVariants[fragmentStageVariant])();
+        }
+
+    private:
+        using FragmentStage = void(PipelineThread::*)();
+
+        template<uint32_t... Variants>
+        static constexpr std::array<FragmentStage, sizeof...(Variants)> CreateFragmentStageVariants(std::integer_sequence<uint32_t, Variants...>)
+        {
+            return {{ &PipelineThread::ExecuteFragmentShader<PipelineTraits<Shaders, FragmentStageVariantState<Variants>>>... }};
+        }
+
+        // Fragment stage instantiated for all possible depth & color write states, so that none of them is branched on per sample
+        static constexpr std::array<FragmentStage, g_scNumFragmentStageVariants> s_FragmentStageVariants =
+            CreateFragmentStageVariants(std::make_integer_sequence<uint32_t, g_scNumFragmentStageVariants>{});
+    };
+
+    // Pipeline with VS/FS functors, attribute layout and shader hints known at compile-time
+    template<typename VS, typename FS, typename AttribLayout, uint8_t ShaderHints = 0u>
+    using TypedShaderPipeline = ShaderPipelineImpl<StaticShaders<VS, FS, AttribLayout, ShaderHints>>;
+}
+
+#include "PipelineThreadKernels.h"
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "ThreadAffinity.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace tyler
+{
+#if defined(_WIN32)
+    // Processor group & index within group of a logical processor, as processors beyond 64 are only addressable via groups
+    static bool GetProcessorNumber(uint32_t processorIdx, PROCESSOR_NUMBER* pProcessorNumber)
+    {
+        const WORD numGroups = GetActiveProcessorGroupCount();
+        for (WORD group = 0; group < numGroups; group++)
+        {
+            const DWORD numGroupProcessors = GetActiveProcessorCount(group);
+            if (processorIdx < numGroupProcessors)
+            {
+                pProcessorNumber->Group = group;
+                pProcessorNumber->Number = static_cast<BYTE>(processorIdx);
+                pProcessorNumber->Reserved = 0;
+                return true;
+            }
+
+            processorIdx -= numGroupProcessors;
+        }
+
+        return false;
+    }
+
+    std::vector<uint32_t> GetAvailableLogicalProcessors()
+    {
+        std::vector<uint32_t> processors;
+
+        // Process affinity mask only covers a single group, so it's only taken into account if there's just one
+        const WORD numGroups = GetActiveProcessorGroupCount();
+
+        DWORD_PTR processMask = 0u;
+        DWORD_PTR systemMask = 0u;
+        const bool hasProcessMask = (numGroups == 1) && (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) != 0);
+
+        uint32_t processorIdx = 0u;
+        for (WORD group = 0; group < numGroups; group++)
+        {
+            const DWORD numGroupProcessors = GetActiveProcessorCount(group);
+            for (DWORD number = 0; number < numGroupProcessors; number++, processorIdx++)
+            {
+                if (!hasProcessMask || ((processMask & (static_cast<DWORD_PTR>(1) << number)) != 0u))
+                {
+                    processors.push_back(processorIdx);
+                }
+            }
+        }
+
+        return processors;
+    }
+
+    uint32_t GetLogicalProcessorNumaNode(uint32_t processorIdx)
+    {
+        PROCESSOR_NUMBER processorNumber;
+        USHORT nodeIdx;
+
+        if (!GetProcessorNumber(processorIdx, &processorNumber) || !GetNumaProcessorNodeEx(&processorNumber, &nodeIdx) || (nodeIdx == 0xffff))
+        {
+            return 0u;
+        }
+
+        return nodeIdx;
+    }
+
+    bool PinCurrentThreadToLogicalProcessor(uint32_t processorIdx)
+    {
+        PROCESSOR_NUMBER processorNumber;
+        if (!GetProcessorNumber(processorIdx, &processorNumber))
+        {
+            return false;
+        }
+
+        GROUP_AFFINITY affinity = {};
+        affinity.Mask = static_cast<KAFFINITY>(1) << processorNumber.Number;
+        affinity.Group = processorNumber.Group;
+
+        return (SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0);
+    }
+#else
+    std::vector<uint32_t> GetAvailableLogicalProcessors()
+    {
+        std::vector<uint32_t> processors;
+
+        // CPUs may be offline or excluded by a cpuset/taskset, so their indices aren't necessarily 0..N-1
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+
+        if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0)
+        {
+            return processors;
+        }
+
+        for (uint32_t processorIdx = 0; processorIdx < CPU_SETSIZE; processorIdx++)
+        {
+            if (CPU_ISSET(processorIdx, &cpuSet))
+            {
+                processors.push_back(processorIdx);
+            }
+        }
+
+        return processors;
+    }
+
+    uint32_t GetLogicalProcessorNumaNode(uint32_t processorIdx)
+    {
+        // sysfs directory of each CPU links to its node as nodeN
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", processorIdx);
+
+        DIR* pDir = opendir(path);
+        if (pDir == nullptr)
+        {
+            return 0u;
+        }
+
+        uint32_t nodeIdx = 0u;
+        while (const dirent* pEntry = readdir(pDir))
+        {
+            if (sscanf(pEntry->d_name, "node%u", &nodeIdx) == 1)
+            {
+                break;
+            }
+        }
+
+        closedir(pDir);
+
+        return nodeIdx;
+    }
+
+    bool PinCurrentThreadToLogicalProcessor(uint32_t processorIdx)
+    {
+        if (processorIdx >= CPU_SETSIZE)
+        {
+            return false;
+        }
+
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(processorIdx, &cpuSet);
+
+        return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+    }
+#endif
+
+    std::vector<uint32_t> ComputePipelineThreadProcessors(const RasterizerConfig& config)
+    {
+        std::vector<uint32_t> threadProcessors;
+
+        if (config.m_ThreadAffinity == ThreadAffinity::NONE)
+        {
+            return threadProcessors;
+        }
+
+        threadProcessors.resize(config.m_NumPipelineThreads);
+
+        if (config.m_ThreadAffinity == ThreadAffinity::EXPLICIT)
+        {
+            ASSERT(!config.m_ThreadAffinityProcessors.empty());
+            if (config.m_ThreadAffinityProcessors.empty())
+            {
+                threadProcessors.clear();
+                return threadProcessors;
+            }
+
+            for (uint32_t threadIdx = 0; threadIdx < config.m_NumPipelineThreads; threadIdx++)
+            {
+                threadProcessors[threadIdx] = config.m_ThreadAffinityProcessors[threadIdx % config.m_ThreadAffinityProcessors.size()];
+            }
+
+            return threadProcessors;
+        }
+
+        const std::vector<uint32_t> availableProcessors = GetAvailableLogicalProcessors();
+        if (availableProcessors.empty())
+        {
+            WARN("Logical processors available to pipeline threads are unknown, threads won't be pinned\n");
+            threadProcessors.clear();
+            return threadProcessors;
+        }
+
+        // Group logical processors by NUMA node, in increasing index order within each node
+        std::vector<std::vector<uint32_t>> nodeProcessors;
+
+        const uint32_t numProcessors = static_cast<uint32_t>(availableProcessors.size());
+        for (uint32_t processorIdx : availableProcessors)
+        {
+            const uint32_t nodeIdx = GetLogicalProcessorNumaNode(processorIdx);
+            if (nodeIdx >= nodeProcessors.size())
+            {
+                nodeProcessors.resize(nodeIdx + 1u);
+            }
+
+            nodeProcessors[nodeIdx].push_back(processorIdx);
+        }
+
+        // Node indices may not be contiguous
+        nodeProcessors.erase(std::remove_if(nodeProcessors.begin(), nodeProcessors.end(), [](const std::vector<uint32_t>& processors)
+        {
+            return processors.empty();
+        }), nodeProcessors.end());
+
+        ASSERT(!nodeProcessors.empty());
+
+        const uint32_t numNodes = static_cast<uint32_t>(nodeProcessors.size());
+        for (uint32_t threadIdx = 0; threadIdx < config.m_NumPipelineThreads; threadIdx++)
+        {
+            if (config.m_ThreadAffinity == ThreadAffinity::COMPACT)
+            {
+                // Fill up a node before moving on to the next one, wrapping around when there are more threads than processors
+                uint32_t processorIdx = threadIdx % numProcessors;
+                uint32_t nodeIdx = 0u;
+                while (processorIdx >= nodeProcessors[nodeIdx].size())
+                {
+                    processorIdx -= static_cast<uint32_t>(nodeProcessors[nodeIdx].size());
+                    nodeIdx++;
+                }
+
+                threadProcessors[threadIdx] = nodeProcessors[nodeIdx][processorIdx];
+            }
+            else
+            {
+                // Deal threads out to nodes in turn
+                const std::vector<uint32_t>& processors = nodeProcessors[threadIdx % numNodes];
+                threadProcessors[threadIdx] = processors[(threadIdx / numNodes) % processors.size()];
+            }
+        }
+
+        return threadProcessors;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "RasterizerConfig.h"
+
+namespace tyler
+{
+    static constexpr uint32_t   g_scInvalidProcessorIndex = 0xffffffff;
+
+    // Platform queries & pinning of threads to logical processors, which are indexed from 0 across all processor groups
+
+    // Logical processors the process is allowed to run on in increasing index order, empty if they can't be determined
+    std::vector<uint32_t> GetAvailableLogicalProcessors();
+
+    // NUMA node the logical processor belongs to, 0 if it's unknown
+    uint32_t GetLogicalProcessorNumaNode(uint32_t processorIdx);
+
+    // Restrict the calling thread to run only on the logical processor, returns false if it isn't possible
+    bool PinCurrentThreadToLogicalProcessor(uint32_t processorIdx);
+
+    // Logical processor each pipeline thread is to be pinned to as per m_ThreadAffinity, empty if threads aren't pinned (incl. if available processors are unknown)
+    std::vector<uint32_t> ComputePipelineThreadProcessors(const RasterizerConfig& config);
+}
\ No newline at end of file
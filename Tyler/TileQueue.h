@@ -4,28 +4,80 @@ namespace tyler
 {
     static constexpr uint32_t   g_scInvalidTileIndex = 0xffffffff;
 
+    // Set in binned primitive indices of primitives that trivially accept the tile, when TA coverage masks aren't emitted by the binner (see g_scBinnerEmitsTrivialAcceptMasks)
+    static constexpr uint32_t   g_scBinnedPrimTrivialAcceptFlag = 0x80000000;
+
+    // Tile queue entries of a tile fragment-shaded in multiple parts (work items) carry the index of the work item in upper bits, which is
+    // a sub-tile of a split tile (see g_scTileSplittingEnabled) or a per-thread bin of the tile in an order-independent drawcall (see PipelineStateDesc)
+    static constexpr uint32_t   g_scWorkItemIndexShift = 24u;
+    static constexpr uint32_t   g_scTileIndexMask = (1u << g_scWorkItemIndexShift) - 1u;
+
     // A tile is a rectangular subregion of a frame buffer
     struct Tile
     {
         Tile() {}
-        Tile(const Tile& other) { m_IsTileQueued.clear(std::memory_order_relaxed); }
+        Tile(const Tile& other) : m_PosX(other.m_PosX), m_PosY(other.m_PosY), m_DispatchOrder(other.m_DispatchOrder) {}
         Tile& operator=(const Tile& other)
         {
             m_PosX = other.m_PosX;
             m_PosY = other.m_PosY;
+            m_DispatchOrder = other.m_DispatchOrder;
 
-            m_IsTileQueued.clear(std::memory_order_relaxed);
+            m_NumQueuedIterations = 0u;
+            m_NumShadedIterations.store(0u, std::memory_order_relaxed);
 
             return *this;
         }
 
         // Position of tile within framebuffer
-        float               m_PosX;
-        float               m_PosY;
+        float                   m_PosX;
+        float                   m_PosY;
+
+        // Sort key of the tile in the tile queue, see g_scTileDispatchOrder
+        uint32_t                m_DispatchOrder = 0u;
+
+        // # draw iterations the tile was queued for rasterization/fragment-shaded in, so that
+        // a tile is fragment-shaded in draw iteration order when draw iterations overlap (see g_scMaxDrawIterationsInFlight)
+        uint32_t                m_NumQueuedIterations = 0u;
+        std::atomic<uint32_t>   m_NumShadedIterations { 0u };
+    };
+
+    // State of a tile in a single draw iteration
+    struct TileIterationState
+    {
+        TileIterationState() {}
+        TileIterationState(const TileIterationState& other)
+        {
+            m_IsTileQueued.clear(std::memory_order_relaxed);
+            m_IsTileBufferLoadStarted.clear(std::memory_order_relaxed);
+        }
 
         // Indicates if the tile is already queued for rasterization,
         // which is done once when a tile receives its first input primitive
         std::atomic_flag    m_IsTileQueued;
+
+        // Indicates if rasterization of the tile is completed in the draw iteration,
+        // after which the tile can be fragment-shaded (by any thread)
+        std::atomic<bool>   m_IsTileRasterized { false };
+
+        // # draw iterations the tile was queued in before, i.e. Tile::m_NumShadedIterations when the tile can be fragment-shaded in the draw iteration
+        uint32_t            m_ShadingOrder = 0u;
+
+        // Estimated cost of rasterizing & fragment-shading the tile in the draw iteration, see g_scCostAwareTileSchedulingEnabled
+        uint32_t            m_EstimatedCost = 0u;
+
+        // Coarse rank of the estimated cost which queued tiles are ordered by, see ScheduleQueuedTilesByCost()
+        uint32_t            m_CostClass = 0u;
+
+        // # tile queue entries (work items) of the tile in the draw iteration, 1 if it's fragment-shaded as a whole
+        uint32_t            m_NumWorkItems = 1u;
+
+        // Tile buffers of a tile with multiple work items are loaded by the first thread to start fragment-shading any of them
+        std::atomic_flag    m_IsTileBufferLoadStarted;
+        std::atomic<bool>   m_IsTileBufferLoadComplete { false };
+
+        // # work items of the tile fragment-shaded so far, the tile is fragment-shaded when all of them are
+        std::atomic<uint32_t>   m_NumWorkItemsShaded { 0u };
     };
 
     // Atomically-operated fixed-size FIFO of tile indices which
@@ -75,6 +127,61 @@ namespace tyler
             m_pData[prevTail] = tileIdx;
         }
 
+        // Reorder tile indices inserted so far, which must be done before any of them is removed/fetched
+        template<typename Compare>
+        void SortTileIndices(Compare compare)
+        {
+            ASSERT((m_ReadIdx.load(std::memory_order_relaxed) == 0u) && (m_FetchIdx.load(std::memory_order_relaxed) == 0u));
+
+            // Tiles with equal order keep their current order, e.g. insertion order
+            std::stable_sort(m_pData, m_pData + m_WriteIdx.load(std::memory_order_relaxed), compare);
+        }
+
+        // Replace each of the first numTiles tile indices with entries for its work items, i.e. indices i < maxNumWorkItems for which isWorkItem(tileIdx, i) holds,
+        // keeping the rest of the tile indices in order after them. Each tile must have at least one work item
+        template<typename IsWorkItem>
+        void SplitTileIndices(uint32_t numTiles, uint32_t maxNumWorkItems, IsWorkItem isWorkItem)
+        {
+            ASSERT((m_ReadIdx.load(std::memory_order_relaxed) == 0u) && (m_FetchIdx.load(std::memory_order_relaxed) == 0u));
+            ASSERT(maxNumWorkItems <= (UINT32_MAX >> g_scWorkItemIndexShift) + 1u);
+
+            const uint32_t numTileIndices = m_WriteIdx.load(std::memory_order_relaxed);
+            ASSERT(numTiles <= numTileIndices);
+
+            uint32_t numWorkItems = 0u;
+            for (uint32_t i = 0; i < numTiles; i++)
+            {
+                for (uint32_t workItemIdx = 0; workItemIdx < maxNumWorkItems; workItemIdx++)
+                {
+                    numWorkItems += isWorkItem(m_pData[i], workItemIdx) ? 1u : 0u;
+                }
+            }
+
+            ASSERT((numWorkItems >= numTiles) && ((numTileIndices - numTiles + numWorkItems) <= m_DataSize));
+
+            memmove(&m_pData[numWorkItems], &m_pData[numTiles], sizeof(uint32_t) * (numTileIndices - numTiles));
+
+            // Back to front, so that tile indices aren't overwritten by work items of preceding tiles before they're split
+            uint32_t writeIdx = numWorkItems;
+            for (uint32_t i = numTiles; i-- > 0;)
+            {
+                const uint32_t tileIdx = m_pData[i];
+                ASSERT(tileIdx <= g_scTileIndexMask);
+
+                for (uint32_t workItemIdx = maxNumWorkItems; workItemIdx-- > 0;)
+                {
+                    if (isWorkItem(tileIdx, workItemIdx))
+                    {
+                        m_pData[--writeIdx] = tileIdx | (workItemIdx << g_scWorkItemIndexShift);
+                    }
+                }
+
+                ASSERT(writeIdx >= i);
+            }
+
+            m_WriteIdx.store(numTileIndices - numTiles + numWorkItems, std::memory_order_relaxed);
+        }
+
         // Return next tileIdx and decrement readIdx
         uint32_t RemoveTileIndex()
         {
@@ -18,6 +18,9 @@ namespace tyler
 #define LOG(...) 
 #endif
 
+// Unlike LOG, warnings about the engine not running as configured are reported in all builds
+#define WARN(...) do { fprintf(stderr, __VA_ARGS__); } while(false)
+
 #define EDGE_TEST_SHARED_EDGES
 
     struct Rect2D
@@ -28,6 +31,15 @@ namespace tyler
         float   m_MaxY;
     };
 
+    // Max of 4 packed floats
+    static float HorizontalMax(const __m128& sseValues)
+    {
+        __m128 sseMax = _mm_max_ps(sseValues, _mm_shuffle_ps(sseValues, sseValues, _MM_SHUFFLE(1, 0, 3, 2)));
+        sseMax = _mm_max_ps(sseMax, _mm_shuffle_ps(sseMax, sseMax, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        return _mm_cvtss_f32(sseMax);
+    }
+
     // Scalar debug function to evaluate edge function E(x, y) and sample(x, y) with tie-breaking rules
     static bool EvaluateEdgeFunction(const glm::vec3& E, const glm::vec2& sample)
     {
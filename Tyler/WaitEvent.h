@@ -0,0 +1,71 @@
+#pragma once
+
+namespace tyler
+{
+    // Hybrid spin-then-block wait on a condition that's signaled by other threads.
+    // Waiters spin for a while before parking, where spin count adapts to how long waits on the event usually take
+    struct WaitEvent
+    {
+        // Stall callee until given predicate returns true, predicate is re-evaluated whenever event is notified
+        template<typename Predicate>
+        void Wait(Predicate predicate)
+        {
+            const uint32_t spinCount = m_SpinCount.load(std::memory_order_relaxed);
+
+            for (uint32_t i = 0; i < spinCount; i++)
+            {
+                if (predicate())
+                {
+                    // Condition met while spinning, allow longer spins for next waits
+                    m_SpinCount.store(glm::min(2 * spinCount, g_scWaitEventMaxSpinCount), std::memory_order_relaxed);
+                    return;
+                }
+
+                _mm_pause();
+            }
+
+            // Condition didn't arrive soon enough, park until notified and shorten next spins
+            m_SpinCount.store(glm::max(spinCount / 2, g_scWaitEventMinSpinCount), std::memory_order_relaxed);
+
+            // Notifier must either observe parked waiter or waiter must observe notifier's update to condition
+            m_NumParkedWaiters.fetch_add(1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_ConditionVariable.wait(lock, predicate);
+            }
+
+            m_NumParkedWaiters.fetch_sub(1u, std::memory_order_relaxed);
+            m_NumParks.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        // Wake up all waiters to re-evaluate their predicates, must be called after updating condition
+        void NotifyAll()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // No syscalls unless there are waiters parked
+            if (m_NumParkedWaiters.load(std::memory_order_relaxed) > 0u)
+            {
+                // Waiter may be between its last predicate evaluation and parking, so condition variable is only notified after it's parked
+                {
+                    std::lock_guard<std::mutex> lock(m_Mutex);
+                }
+                m_ConditionVariable.notify_all();
+            }
+        }
+
+        // # waits that ended up parking the waiter
+        std::atomic<uint32_t>       m_NumParks { 0u };
+
+        // Current spin count before parking
+        std::atomic<uint32_t>       m_SpinCount { g_scWaitEventMaxSpinCount };
+
+        // # waiters parked or about to park
+        std::atomic<uint32_t>       m_NumParkedWaiters { 0u };
+
+        std::mutex                  m_Mutex;
+        std::condition_variable     m_ConditionVariable;
+    };
+}
\ No newline at end of file
@@ -1,10 +1,18 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdio>
 #include <cassert>
+#include <cfloat>
+#include <algorithm>
+#include <array>
+#include <utility>
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <immintrin.h>
 
 //#define GLM_FORCE_MESSAGES